@@ -114,9 +114,10 @@ set(OBJ_STL
 )
 
 set(OBJ_CC
-  tools/random.cc tools/rng.cc tools/ranvar.cc common/misc.cc common/timer-handler.cc
+  tools/random.cc tools/rng.cc tools/ranvar.cc common/misc.cc common/batch.cc common/timer-handler.cc
   common/scheduler.cc common/object.cc common/packet.cc common/ip.cc routing/route.cc 
   common/connector.cc common/ttl.cc trace/trace.cc trace/trace-ip.cc
+  trace/binary-queue-trace.cc
   classifier/classifier.cc classifier/classifier-addr.cc classifier/classifier-hash.cc
   classifier/classifier-virtual.cc classifier/classifier-mcast.cc
   classifier/classifier-bst.cc classifier/classifier-mpath.cc mcast/replicator.cc
@@ -239,7 +240,8 @@ set(OBJ_CC
   pushback/pushback-queue.cc pushback/pushback.cc 
   common/parentnode.cc trace/basetrace.cc 
   common/simulator.cc asim/asim.cc 
-  common/scheduler-map.cc common/splay-scheduler.cc 
+  common/scheduler-map.cc common/splay-scheduler.cc common/ladder-scheduler.cc 
+  common/partitioned-scheduler.cc 
   linkstate/ls.cc linkstate/rtProtoLS.cc 
   pgm/classifier-pgm.cc pgm/pgm-agent.cc pgm/pgm-sender.cc 
   pgm/pgm-receiver.cc mcast/rcvbuf.cc 
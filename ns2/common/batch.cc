@@ -0,0 +1,291 @@
+/* -*-	Mode:C++; c-basic-offset:8; tab-width:8; indent-tabs-mode:t -*- */
+/*
+ * Batch mode, for running one script with many seeds:
+ *
+ *	ns -batch runs [-jobs n] [-batch-log file] script.tcl args...
+ *
+ * The script builds whatever is common to all runs and then calls
+ * "ns-checkpoint".  There ns forks a child for each line of the runs file
+ * ("-" for stdin), which is a Tcl list
+ *
+ *	seed ?var value ...?
+ *
+ * The child reseeds the random number generators, sets the given global
+ * variables and carries on with the script; ns-checkpoint returns the
+ * number of the run in it.  Starting Tcl, loading the library and building
+ * the scenario is thus done once and shared copy-on-write by all runs.
+ * The parent runs at most n children at a time, one per processor by
+ * default, and exits with status 1 if any of them failed.  As each child
+ * exits, the parent appends "run status" to the -batch-log file, so that
+ * a driver can pick up the results of a run without waiting for the rest.
+ *
+ * Channels opened before the checkpoint are shared by all the runs, so
+ * per-run output must be opened after it.  So must binary queue traces,
+ * whose writer threads do not survive fork().
+ *
+ * Without -batch, ns-checkpoint does nothing.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef WIN32
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#include <map>
+#include <string>
+#include <vector>
+
+#include "config.h"
+#include "rng.h"
+#include "binary-queue-trace.h"
+
+static const char* runs_file;	// -batch
+static int max_jobs;		// -jobs
+static const char* log_file;	// -batch-log
+
+/*
+ * Take -batch, -jobs and -batch-log off the front of argv before
+ * Tcl_Main() mistakes them for the script.  Returns the new argc.
+ */
+int
+batch_options(int argc, char** argv)
+{
+	int i = 1;
+	for (; i + 1 < argc; i += 2) {
+		if (strcmp(argv[i], "-batch") == 0)
+			runs_file = argv[i + 1];
+		else if (strcmp(argv[i], "-jobs") == 0)
+			max_jobs = atoi(argv[i + 1]);
+		else if (strcmp(argv[i], "-batch-log") == 0)
+			log_file = argv[i + 1];
+		else
+			break;
+	}
+	if (i > 1) {
+		// argv[argc] is null and moves along
+		memmove(argv + 1, argv + i, (argc - i + 1) * sizeof(char*));
+		argc -= i - 1;
+	}
+	return (argc);
+}
+
+class CheckpointCommand : public TclCommand {
+public:
+	CheckpointCommand() : TclCommand("ns-checkpoint") { }
+	virtual int command(int argc, const char*const* argv);
+protected:
+	int read_runs(std::vector<std::string>& runs);
+	int start_run(int run, const std::string& spec);
+	void reseed(int seed);
+};
+
+/* Read the runs file into runs, one spec per line. */
+int
+CheckpointCommand::read_runs(std::vector<std::string>& runs)
+{
+	Tcl& tcl = Tcl::instance();
+	FILE* f = strcmp(runs_file, "-") == 0 ? stdin : fopen(runs_file, "r");
+	if (f == 0) {
+		tcl.resultf("ns-checkpoint: %s: %s", runs_file, strerror(errno));
+		return (TCL_ERROR);
+	}
+
+	int lineno = 0;
+	std::string line;
+	char buf[1024];
+	while (fgets(buf, sizeof(buf), f) != 0) {
+		line += buf;
+		if (line[line.size() - 1] != '\n' && !feof(f))
+			continue;
+		lineno++;
+
+		int n;
+		const char** v;
+		size_t start = line.find_first_not_of(" \t\r\n");
+		if (start != std::string::npos && line[start] != '#') {
+			if (Tcl_SplitList(0, line.c_str(), &n, &v) != TCL_OK) {
+				n = 0;
+				v = 0;
+			}
+			char* end = 0;
+			long seed = n > 0 ? strtol(v[0], &end, 10) : -1;
+			bool ok = end != 0 && *end == 0 && seed >= 0 &&
+				seed < MAXINT && n % 2 == 1;
+			if (v != 0)
+				Tcl_Free((char*)v);
+			if (!ok) {
+				tcl.resultf("ns-checkpoint: %s:%d: "
+					    "expected \"seed ?var value ...?\"",
+					    runs_file, lineno);
+				if (f != stdin)
+					fclose(f);
+				return (TCL_ERROR);
+			}
+			runs.push_back(line.substr(start,
+				line.find_last_not_of(" \t\r\n") + 1 - start));
+		}
+		line.clear();
+	}
+	if (f != stdin)
+		fclose(f);
+	return (TCL_OK);
+}
+
+/*
+ * Reseed the default generator as "$defaultRNG seed" does, then move the
+ * other generators onto the streams that follow, in the order in which
+ * they were created, as if they had all been created after the seed.
+ */
+void
+CheckpointCommand::reseed(int seed)
+{
+	RNG* def = RNG::defaultrng();
+	if (seed != 0)
+		def->set_seed(RNG::RAW_SEED_SOURCE, seed);
+	else
+		def->set_seed(RNG::HEURISTIC_SEED_SOURCE, 0);
+
+#ifndef OLD_RNG
+	Tcl& tcl = Tcl::instance();
+	tcl.evalc("lsort -dictionary [RNG info instances]");
+	int n;
+	const char** v;
+	if (Tcl_SplitList(0, tcl.result(), &n, &v) != TCL_OK)
+		return;
+	for (int i = 0; i < n; i++) {
+		RNG* rng = (RNG*)TclObject::lookup(v[i]);
+		if (rng != 0 && rng != def)
+			rng->init();
+	}
+	Tcl_Free((char*)v);
+#endif
+}
+
+/* The child's side of the fork: set up run number run and return. */
+int
+CheckpointCommand::start_run(int run, const std::string& spec)
+{
+	Tcl& tcl = Tcl::instance();
+	int n;
+	const char** v;
+	Tcl_SplitList(0, spec.c_str(), &n, &v);
+	reseed(atoi(v[0]));
+	for (int i = 1; i + 1 < n; i += 2) {
+		if (Tcl_SetVar(tcl.interp(), v[i], v[i + 1],
+			       TCL_GLOBAL_ONLY | TCL_LEAVE_ERR_MSG) == 0) {
+			Tcl_Free((char*)v);
+			return (TCL_ERROR);
+		}
+	}
+	Tcl_Free((char*)v);
+	tcl.resultf("%d", run);
+	return (TCL_OK);
+}
+
+/*
+ * ns-checkpoint
+ */
+int
+CheckpointCommand::command(int, const char*const*)
+{
+	Tcl& tcl = Tcl::instance();
+	if (runs_file == 0)
+		return (TCL_OK);
+#ifdef WIN32
+	tcl.result("ns-checkpoint: batch mode needs fork()");
+	return (TCL_ERROR);
+#else
+	if (BinaryQueueTrace::any_open()) {
+		tcl.result("ns-checkpoint: binary queue traces must be "
+			   "opened after the checkpoint");
+		return (TCL_ERROR);
+	}
+	std::vector<std::string> runs;
+	if (read_runs(runs) != TCL_OK)
+		return (TCL_ERROR);
+	// a checkpoint reached again in a child does nothing
+	runs_file = 0;
+
+	int jobs = max_jobs;
+	if (jobs <= 0)
+		jobs = sysconf(_SC_NPROCESSORS_ONLN);
+	if (jobs <= 0)
+		jobs = 1;
+
+	FILE* log = 0;
+	if (log_file != 0 && (log = fopen(log_file, "a")) == 0) {
+		tcl.resultf("ns-checkpoint: %s: %s", log_file, strerror(errno));
+		return (TCL_ERROR);
+	}
+	if (log != 0)
+		setvbuf(log, 0, _IOLBF, 0);
+
+	// buffered output would otherwise be written by every child
+	tcl.evalc("foreach c [file channels] { catch { flush $c } }");
+	fflush(0);
+
+	std::map<pid_t, int> children;
+	int failed = 0;
+	int next = 0;
+	while (next < (int)runs.size() || !children.empty()) {
+		if (next < (int)runs.size() && (int)children.size() < jobs) {
+			pid_t pid = fork();
+			if (pid == 0) {
+				if (log != 0)
+					fclose(log);
+				return (start_run(next, runs[next]));
+			}
+			if (pid < 0) {
+				fprintf(stderr, "ns: run %d: fork: %s\n",
+					next, strerror(errno));
+				failed++;
+				if (log != 0)
+					fprintf(log, "%d %d\n", next, 127);
+			} else
+				children[pid] = next;
+			next++;
+			continue;
+		}
+
+		int status;
+		pid_t pid = waitpid(-1, &status, 0);
+		if (pid < 0) {
+			if (errno == EINTR)
+				continue;
+			fprintf(stderr, "ns: waitpid: %s\n", strerror(errno));
+			failed += children.size();
+			break;
+		}
+		std::map<pid_t, int>::iterator it = children.find(pid);
+		if (it == children.end())
+			continue;
+		int run = it->second;
+		if (log != 0)
+			fprintf(log, "%d %d\n", run, WIFSIGNALED(status) ?
+				128 + WTERMSIG(status) : WEXITSTATUS(status));
+		if (WIFSIGNALED(status)) {
+			fprintf(stderr, "ns: run %d killed by signal %d: %s\n",
+				run, WTERMSIG(status), runs[run].c_str());
+			failed++;
+		} else if (WEXITSTATUS(status) != 0) {
+			fprintf(stderr, "ns: run %d exited with status %d: %s\n",
+				run, WEXITSTATUS(status), runs[run].c_str());
+			failed++;
+		}
+		children.erase(it);
+	}
+	if (log != 0)
+		fclose(log);
+	Tcl_Exit(failed != 0 ? 1 : 0);
+	return (TCL_OK);	/*NOTREACHED*/
+#endif
+}
+
+void init_batch(void)
+{
+	(void)new CheckpointCommand;
+}
@@ -0,0 +1,314 @@
+/* -*-	Mode:C++; c-basic-offset:8; tab-width:8; indent-tabs-mode:t -*- */
+
+/*
+ * Scheduler based on a ladder queue.
+ *
+ * W. T. Tang, R. S. M. Goh and I. L.-J. Thng. Ladder Queue: An O(1)
+ * Priority Queue Structure for Large-Scale Discrete Event Simulation.
+ * ACM TOMACS, 15(3):175--204, 2005.
+ *
+ * Events pass through three tiers.  Top is an unsorted list of
+ * everything at or after top_start_.  When the rest of the queue runs
+ * dry, Top is spread over the buckets of the first rung of the ladder.
+ * A bucket holding more than THRESHOLD events is in turn spread over a
+ * new, finer rung below it; smaller buckets are sorted into Bottom,
+ * from which events are dequeued.  Every event is moved a bounded
+ * number of times, so insert and deque are O(1) amortized.
+ *
+ * Implementation notes: all lists are circular and headed by sentinel
+ * events, so that cancel() unlinks an event through Event::prev_ in
+ * O(1) without knowing which tier holds it.  Bucket indices depend
+ * monotonically on time_, lists are only ever appended to, and buckets
+ * are sorted stably, so simultaneous events leave in the order they
+ * were inserted, as with the other schedulers.
+ */
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "scheduler.h"
+
+static class LadderSchedulerClass : public TclClass {
+public:
+	LadderSchedulerClass() : TclClass("Scheduler/Ladder") {}
+	TclObject* create(int /* argc */, const char*const* /* argv */) {
+		return (new LadderScheduler);
+	}
+} class_ladder_sched;
+
+static inline void
+list_init(Event* s)
+{
+	s->next_ = s->prev_ = s;
+}
+
+static inline bool
+list_empty(const Event* s)
+{
+	return (s->next_ == s);
+}
+
+static inline int
+list_length(const Event* s)
+{
+	int n = 0;
+	for (const Event* e = s->next_; e != s; e = e->next_)
+		n++;
+	return (n);
+}
+
+static inline void
+list_append(Event* s, Event* e)
+{
+	e->prev_ = s->prev_;
+	e->next_ = s;
+	s->prev_->next_ = e;
+	s->prev_ = e;
+}
+
+static inline void
+list_unlink(Event* e)
+{
+	e->prev_->next_ = e->next_;
+	e->next_->prev_ = e->prev_;
+}
+
+static bool
+earlier(const Event* a, const Event* b)
+{
+	return (a->time_ < b->time_);
+}
+
+LadderScheduler::LadderScheduler()
+	: top_start_(-HUGE_VAL), nrungs_(0), nbottom_(0), recount_(0),
+	  qsize_(0), scratch_(0), scratch_size_(0)
+{
+	list_init(&top_);
+	list_init(&bottom_);
+	for (int i = 0; i < MAX_RUNGS; i++) {
+		rungs_[i].buckets_ = 0;
+		rungs_[i].capacity_ = 0;
+		rungs_[i].nbuckets_ = 0;
+		rungs_[i].cur_ = 0;
+	}
+}
+
+LadderScheduler::~LadderScheduler()
+{
+	for (int i = 0; i < MAX_RUNGS; i++)
+		delete [] rungs_[i].buckets_;
+	delete [] scratch_;
+}
+
+/*
+ * Clamping keeps the index monotonic in t even where rounding puts an
+ * event just outside the span the rung was built for.
+ */
+int
+LadderScheduler::bucket(const Rung& r, double t) const
+{
+	double k = (t - r.start_) / r.width_;
+	if (!(k > 0))
+		return 0;
+	if (k >= r.nbuckets_)
+		return r.nbuckets_ - 1;
+	return (int)k;
+}
+
+void
+LadderScheduler::insert(Event* e)
+{
+	double t = e->time_;
+	qsize_++;
+	if (t >= top_start_) {
+		list_append(&top_, e);
+		return;
+	}
+	for (int i = 0; i < nrungs_; i++) {
+		Rung& r = rungs_[i];
+		int k = bucket(r, t);
+		if (k >= r.cur_) {
+			list_append(&r.buckets_[k], e);
+			return;
+		}
+	}
+	insert_bottom(e);
+}
+
+void
+LadderScheduler::insert_bottom(Event* e)
+{
+	Event* p = bottom_.prev_;
+	while (p != &bottom_ && p->time_ > e->time_)
+		p = p->prev_;
+	e->prev_ = p;
+	e->next_ = p->next_;
+	p->next_->prev_ = e;
+	p->next_ = e;
+
+	/*
+	 * Too many events due before the whole ladder: turn Bottom into a
+	 * new rung rather than keep inserting into a long sorted list.
+	 * cancel() cannot tell whether it took an event out of Bottom, so
+	 * after a cancel nbottom_ may be too high and Bottom is counted.
+	 */
+	if (++nbottom_ > THRESHOLD && recount_) {
+		nbottom_ = list_length(&bottom_);
+		recount_ = 0;
+	}
+	if (nbottom_ > THRESHOLD &&
+	    spawn(&bottom_, nbottom_, bottom_.next_->time_, bottom_.prev_->time_))
+		nbottom_ = 0;
+}
+
+/*
+ * Spread the n events of list over a new rung covering [min, max].
+ * Returns 0, leaving list alone, if the ladder is full or the events
+ * cannot be told apart by time.
+ */
+int
+LadderScheduler::spawn(Event* list, int n, double min, double max)
+{
+	if (nrungs_ == MAX_RUNGS)
+		return 0;
+	int nbuckets = std::min(n, (int)MAX_BUCKETS);
+	double width = (max - min) / nbuckets;
+	if (!(width > 0))
+		return 0;
+
+	Rung& r = rungs_[nrungs_++];
+	if (r.capacity_ < nbuckets) {
+		delete [] r.buckets_;
+		r.capacity_ = std::max(nbuckets, 2 * r.capacity_);
+		r.buckets_ = new Event[r.capacity_];
+	}
+	r.nbuckets_ = nbuckets;
+	r.cur_ = 0;
+	r.start_ = min;
+	r.width_ = width;
+	for (int i = 0; i < nbuckets; i++)
+		list_init(&r.buckets_[i]);
+
+	Event* e = list->next_;
+	while (e != list) {
+		Event* next = e->next_;
+		list_append(&r.buckets_[bucket(r, e->time_)], e);
+		e = next;
+	}
+	list_init(list);
+	return 1;
+}
+
+void
+LadderScheduler::sort_to_bottom(Event* list, int n)
+{
+	if (scratch_size_ < n) {
+		delete [] scratch_;
+		scratch_size_ = std::max(n, 2 * scratch_size_);
+		scratch_ = new Event*[scratch_size_];
+	}
+	int i = 0;
+	for (Event* e = list->next_; e != list; e = e->next_)
+		scratch_[i++] = e;
+	std::stable_sort(scratch_, scratch_ + n, earlier);
+
+	list_init(list);
+	for (i = 0; i < n; i++)
+		list_append(&bottom_, scratch_[i]);
+	nbottom_ = n;
+	recount_ = 0;
+}
+
+/*
+ * Move the earliest events down the ladder until Bottom is non-empty
+ * or the queue turns out to be empty.
+ */
+void
+LadderScheduler::fill_bottom()
+{
+	while (list_empty(&bottom_)) {
+		Event* list;
+		if (nrungs_ == 0) {
+			if (list_empty(&top_))
+				return;
+			list = &top_;
+		} else {
+			Rung& r = rungs_[nrungs_ - 1];
+			while (r.cur_ < r.nbuckets_ &&
+			       list_empty(&r.buckets_[r.cur_]))
+				r.cur_++;
+			if (r.cur_ == r.nbuckets_) {
+				nrungs_--;
+				continue;
+			}
+			list = &r.buckets_[r.cur_++];
+		}
+
+		int n = 0;
+		double min = HUGE_VAL, max = -HUGE_VAL;
+		for (Event* e = list->next_; e != list; e = e->next_) {
+			n++;
+			min = std::min(min, e->time_);
+			max = std::max(max, e->time_);
+		}
+		if (list == &top_)
+			top_start_ = max;
+		if (n <= THRESHOLD || !spawn(list, n, min, max))
+			sort_to_bottom(list, n);
+	}
+}
+
+Event*
+LadderScheduler::deque()
+{
+	fill_bottom();
+	Event* e = bottom_.next_;
+	if (e == &bottom_)
+		return (0);
+	list_unlink(e);
+	qsize_--;
+	if (nbottom_ > 0)
+		nbottom_--;
+	return (e);
+}
+
+const Event*
+LadderScheduler::head()
+{
+	fill_bottom();
+	return (list_empty(&bottom_) ? 0 : bottom_.next_);
+}
+
+void
+LadderScheduler::cancel(Event* e)
+{
+	if (e->uid_ <= 0)	// event not in queue
+		return;
+	list_unlink(e);
+	e->uid_ = - e->uid_;
+	qsize_--;
+	recount_ = 1;
+}
+
+Event*
+LadderScheduler::lookup(scheduler_uid_t uid)
+{
+	Event* e;
+	for (e = bottom_.next_; e != &bottom_; e = e->next_)
+		if (e->uid_ == uid)
+			return (e);
+	for (int i = nrungs_ - 1; i >= 0; i--) {
+		Rung& r = rungs_[i];
+		for (int k = r.cur_; k < r.nbuckets_; k++) {
+			Event* s = &r.buckets_[k];
+			for (e = s->next_; e != s; e = e->next_)
+				if (e->uid_ == uid)
+					return (e);
+		}
+	}
+	for (e = top_.next_; e != &top_; e = e->next_)
+		if (e->uid_ == uid)
+			return (e);
+	return (0);
+}
@@ -37,6 +37,10 @@ static const char rcsid[] =
     "@(#) $Header: /cvsroot/nsnam/ns-2/common/packet.cc,v 1.19 2008/02/18 03:39:02 tom_henderson Exp $ (LBL)";
 #endif
 
+#include <new>
+#include <vector>
+#include <algorithm>
+
 #include "packet.h"
 #include "flags.h"
 
@@ -59,13 +63,86 @@ int p_info::addPacket(char *name)
 
 int Packet::hdrlen_ = 0;		// size of a packet's header
 Packet* Packet::free_;			// free list
+int Packet::layout_hdrlen_ = -1;
+int Packet::layout_gen_;
+unsigned int Packet::layout_units_;
+unsigned char* Packet::region_of_;
+int Packet::nregions_;
+int Packet::region_off_[MAX_REGIONS + 1];
 int hdr_cmn::offset_;			// static offset of common header
 int hdr_flags::offset_;			// static offset of flags header
 
+PacketHeaderClass* PacketHeaderClass::all_;
+
+/*
+ * Split the header area into at most MAX_REGIONS regions, each starting
+ * at the offset of some header, so that a header lies within the region
+ * its offset falls in.  Free blocks of the previous layout may have the
+ * wrong size, so they are dropped.
+ */
+void
+Packet::new_layout()
+{
+	std::vector<int> starts;
+	starts.push_back(0);
+	for (PacketHeaderClass* c = PacketHeaderClass::all_; c != 0;
+	     c = c->next_hdr_) {
+		if (c->offset_ == 0)
+			continue;
+		int off = *c->offset_;
+		if (off > 0 && off < hdrlen_ && (off & 7) == 0)
+			starts.push_back(off);
+	}
+	std::sort(starts.begin(), starts.end());
+	starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+
+	int n = starts.size();
+	nregions_ = std::min(n, (int)MAX_REGIONS);
+	for (int r = 0; r < nregions_; r++)
+		region_off_[r] = starts[(long)r * n / nregions_];
+	region_off_[nregions_] = hdrlen_;
+
+	layout_units_ = (hdrlen_ + 7) >> 3;
+	delete [] region_of_;
+	region_of_ = new unsigned char[layout_units_ + 1];
+	for (int r = 0; r < nregions_; r++) {
+		unsigned int end = (r + 1 < nregions_) ?
+			region_off_[r + 1] >> 3 : layout_units_;
+		for (unsigned int u = region_off_[r] >> 3; u < end; u++)
+			region_of_[u] = r;
+	}
+
+	layout_hdrlen_ = hdrlen_;
+	layout_gen_++;
+	free_ = 0;
+}
+
+/* Carve a new slab into zeroed, cache-aligned blocks on the free list. */
+void
+Packet::grow()
+{
+	int pktsize = (sizeof(Packet) + CACHE_LINE - 1) & ~(CACHE_LINE - 1);
+	int blksize = pktsize + ((hdrlen_ + CACHE_LINE - 1) & ~(CACHE_LINE - 1));
+	unsigned char* slab =
+		new unsigned char[SLAB_BLOCKS * blksize + CACHE_LINE - 1];
+	memset(slab, 0, SLAB_BLOCKS * blksize + CACHE_LINE - 1);
+	slab += (CACHE_LINE - (size_t)slab % CACHE_LINE) % CACHE_LINE;
+
+	for (int i = SLAB_BLOCKS - 1; i >= 0; i--) {
+		Packet* p = new (slab + i * blksize) Packet;
+		p->bits_ = (unsigned char*)p + pktsize;
+		p->gen_ = layout_gen_;
+		p->fflag_ = FALSE;
+		p->next_ = free_;
+		free_ = p;
+	}
+}
+
 
 PacketHeaderClass::PacketHeaderClass(const char* classname, int hdrlen) : 
-	TclClass(classname), hdrlen_(hdrlen), offset_(0)
+	TclClass(classname), hdrlen_(hdrlen), offset_(0), next_hdr_(all_)
 {
+	all_ = this;
 }
 
 
@@ -102,6 +179,7 @@ int PacketHeaderClass::method(int ac, const char*const* av)
 		if (strcmp(argv[1], "offset") == 0) {
 			if (offset_) {
 				*offset_ = atoi(argv[2]);
+				Packet::invalidate_layout();
 				return TCL_OK;
 			}
 			tcl.resultf("Warning: cannot set offset_ for %s",
@@ -451,33 +451,55 @@ extern p_info packet_info; /* map PT_* to string name */
 //#define OFFSET(type, field)	((long) &((type *)0)->field)
 #define OFFSET(type, field) ( (char *)&( ((type *)256)->field )  - (char *)256)
 
+/*
+ * Copies of a PacketData share one reference-counted buffer, which is
+ * duplicated only when a copy asks for a writable pointer to it.
+ */
 class PacketData : public AppData {
 public:
-	PacketData(int sz) : AppData(PACKET_DATA) {
+	PacketData(int sz) : AppData(PACKET_DATA), buf_(0) {
 		datalen_ = sz;
 		if (datalen_ > 0)
-			data_ = new unsigned char[datalen_];
-		else
-			data_ = NULL;
+			buf_ = newbuf(datalen_);
 	}
-	PacketData(PacketData& d) : AppData(d) {
+	PacketData(PacketData& d) : AppData(d), buf_(d.buf_) {
 		datalen_ = d.datalen_;
-		if (datalen_ > 0) {
-			data_ = new unsigned char[datalen_];
-			memcpy(data_, d.data_, datalen_);
-		} else
-			data_ = NULL;
+		if (buf_ != NULL)
+			buf_->ref_count_++;
+	}
+	virtual ~PacketData() {
+		if (buf_ != NULL && --buf_->ref_count_ == 0)
+			delete [] (unsigned char*)buf_;
 	}
-	virtual ~PacketData() { 
-		if (data_ != NULL) 
-			delete []data_; 
+	unsigned char* data() {
+		if (buf_ == NULL)
+			return NULL;
+		if (buf_->ref_count_ > 1) {
+			Buffer* b = newbuf(datalen_);
+			memcpy(b->bytes(), buf_->bytes(), datalen_);
+			buf_->ref_count_--;
+			buf_ = b;
+		}
+		return buf_->bytes();
+	}
+	const unsigned char* data() const {
+		return (buf_ != NULL ? buf_->bytes() : NULL);
 	}
-	unsigned char* data() { return data_; }
 
 	virtual int size() const { return datalen_; }
 	virtual AppData* copy() { return new PacketData(*this); }
 private:
-	unsigned char* data_;
+	struct Buffer {
+		int ref_count_;
+		int pad_;	// keeps the bytes that follow 8-byte aligned
+		unsigned char* bytes() { return (unsigned char*)(this + 1); }
+	};
+	static Buffer* newbuf(int n) {
+		Buffer* b = (Buffer*)new unsigned char[sizeof(Buffer) + n];
+		b->ref_count_ = 1;
+		return (b);
+	}
+	Buffer* buf_;
 	int datalen_;
 };
 
@@ -492,6 +514,29 @@ private:
 	AppData* data_;		// variable size buffer for 'data'
 	static void init(Packet*);     // initialize pkt hdr 
 	bool fflag_;
+
+	/*
+	 * Packets are carved out of slabs, each block holding the Packet
+	 * followed by its header bits.  Free blocks have all-zero bits;
+	 * dirty_ records which header regions (see new_layout()) were
+	 * handed out by access() since, so that init() clears only those.
+	 */
+	enum { CACHE_LINE = 64, SLAB_BLOCKS = 64, MAX_REGIONS = 64 };
+	static void grow();
+	static void new_layout();
+	inline void touch(int off) const {
+		unsigned int unit = (unsigned int)off >> 3;
+		dirty_ |= (unit < layout_units_) ?
+			(u_int64_t)1 << region_of_[unit] : ~(u_int64_t)0;
+	}
+	mutable u_int64_t dirty_;
+	int gen_;		// layout generation of this block
+	static int layout_hdrlen_;	// hdrlen_ the layout was built for
+	static int layout_gen_;
+	static unsigned int layout_units_;	// 8-byte units of header
+	static unsigned char* region_of_;	// region of each unit
+	static int nregions_;
+	static int region_off_[MAX_REGIONS + 1];
 protected:
 	static Packet* free_;	// packet free list
 	int	ref_count_;	// free the pkt until count to 0
@@ -499,8 +544,9 @@ public:
 	Packet* next_;		// for queues and the free list
 	static int hdrlen_;
 
-	Packet() : bits_(0), data_(0), ref_count_(0), next_(0) { }
-	inline unsigned char* bits() { return (bits_); }
+	Packet() : bits_(0), data_(0), dirty_(0), gen_(0), ref_count_(0),
+		   next_(0) { }
+	inline unsigned char* bits() { dirty_ = ~(u_int64_t)0; return (bits_); }
 	inline Packet* copy() const;
 	inline Packet* refcopy() { ++ref_count_; return this; }
 	inline int& ref_count() { return (ref_count_); }
@@ -510,9 +556,12 @@ public:
 	// dirty hack for diffusion data
 	inline void initdata() { data_  = 0;}
 	static inline void free(Packet*);
+	// header offsets changed; rebuild the layout on the next alloc()
+	static void invalidate_layout() { layout_hdrlen_ = -1; }
 	inline unsigned char* access(int off) const {
 		if (off < 0)
 			abort();
+		touch(off);
 		return (&bits_[off]);
 	}
 	// This is used for backward compatibility, i.e., assuming user data
@@ -680,34 +729,53 @@ protected:
 	inline void offset(int* off) {offset_= off;}
 	int hdrlen_;		// # of bytes for this header
 	int* offset_;		// offset for this header
+	PacketHeaderClass* next_hdr_;
+	static PacketHeaderClass* all_;	// every header class, for Packet
 public:
 	virtual void bind();
 	virtual void export_offsets();
 	TclObject* create(int argc, const char*const* argv);
+	friend class Packet;
 };
 
 
+/* Clear the header regions written since the block was last clean. */
 inline void Packet::init(Packet* p)
 {
-	bzero(p->bits_, hdrlen_);
+	u_int64_t d = p->dirty_;
+	if (d == ~(u_int64_t)0) {
+		bzero(p->bits_, hdrlen_);
+	} else {
+		for (int r = 0; d != 0; ) {
+			if ((d & 1) == 0) {
+				d >>= 1;
+				r++;
+				continue;
+			}
+			int start = r;
+			while (d & 1) {
+				d >>= 1;
+				r++;
+			}
+			bzero(p->bits_ + region_off_[start],
+			      region_off_[r] - region_off_[start]);
+		}
+	}
+	p->dirty_ = 0;
 }
 
 inline Packet* Packet::alloc()
 {
+	if (layout_hdrlen_ != hdrlen_)
+		new_layout();
+	if (free_ == 0)
+		grow();
 	Packet* p = free_;
-	if (p != 0) {
-		assert(p->fflag_ == FALSE);
-		free_ = p->next_;
-		assert(p->data_ == 0);
-		p->uid_ = 0;
-		p->time_ = 0;
-	} else {
-		p = new Packet;
-		p->bits_ = new unsigned char[hdrlen_];
-		if (p == 0 || p->bits_ == 0)
-			abort();
-	}
-	init(p); // Initialize bits_[]
+	assert(p->fflag_ == FALSE);
+	free_ = p->next_;
+	assert(p->data_ == 0);
+	p->uid_ = 0;
+	p->time_ = 0;
 	(HDR_CMN(p))->next_hop_ = -2; // -1 reserved for IP_BROADCAST
 	(HDR_CMN(p))->last_hop_ = -2; // -1 reserved for IP_BROADCAST
 	p->fflag_ = TRUE;
@@ -778,10 +846,13 @@ inline void Packet::free(Packet* p)
 				delete p->data_;
 				p->data_ = 0;
 			}
+			p->fflag_ = FALSE;
+			// blocks of an outdated layout are abandoned
+			if (p->gen_ != layout_gen_)
+				return;
 			init(p);
 			p->next_ = free_;
 			free_ = p;
-			p->fflag_ = FALSE;
 		} else {
 			--p->ref_count_;
 		}
@@ -792,7 +863,18 @@ inline Packet* Packet::copy() const
 {
         hdr_dccp *dccph, *dccph_p;
 	Packet* p = alloc();
-	memcpy(p->bits(), bits_, hdrlen_);
+	if (gen_ != layout_gen_ || dirty_ == ~(u_int64_t)0) {
+		memcpy(p->bits_, bits_, hdrlen_);
+		p->dirty_ = ~(u_int64_t)0;
+	} else {
+		// regions this packet never wrote are zero in both
+		for (int r = 0; r < nregions_; r++)
+			if (dirty_ & ((u_int64_t)1 << r))
+				memcpy(p->bits_ + region_off_[r],
+				       bits_ + region_off_[r],
+				       region_off_[r + 1] - region_off_[r]);
+		p->dirty_ |= dirty_;
+	}
  
         //copy DCCP options_, since it is a pointer
         switch (HDR_CMN(this)->ptype_){
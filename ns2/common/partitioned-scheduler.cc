@@ -0,0 +1,312 @@
+/* -*-	Mode:C++; c-basic-offset:8; tab-width:8; indent-tabs-mode:t -*- */
+
+/*
+ * Scheduler that keeps the events of each logical process (LP) apart.
+ *
+ * This is the sequential half of a conservative parallel scheduler.
+ * Nodes are assigned to LPs from Tcl ("$ns set-lp"), and every link
+ * between nodes in different LPs becomes a cut when the simulation
+ * runs.  An event belongs to the LP of the event that scheduled it,
+ * except that packets delivered across a cut belong to the LP at its
+ * far end.  Each LP has its own event queue.
+ *
+ * Events are still dispatched one at a time in global (time, uid)
+ * order, so results are identical to those of the other schedulers.
+ * Alongside, the scheduler runs the windows of the conservative
+ * protocol: a window opens at the earliest pending event and is as long
+ * as the lookahead, the smallest delay of a cut link.  Within a window
+ * the LPs could run in parallel as long as no event is scheduled for
+ * another LP inside it.  "$sched stats" reports how many events each LP
+ * ran, how many events a parallel run would have had to run one after
+ * the other (the busiest LP of each window, summed over windows), and
+ * how many events broke the window.  That tells whether a partition is
+ * worth running in parallel.  A threaded run needs more: see TODO.html.
+ */
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "scheduler.h"
+#include "delay.h"
+
+static class PartitionedSchedulerClass : public TclClass {
+public:
+	PartitionedSchedulerClass() : TclClass("Scheduler/Partitioned") {}
+	TclObject* create(int /* argc */, const char*const* /* argv */) {
+		return (new PartitionedScheduler);
+	}
+} class_partitioned_sched;
+
+PartitionedScheduler::PartitionedScheduler()
+	: lps_(0), nlps_(0), cuts_(0), ncuts_(0), entries_(0), nentries_(0),
+	  lp_(0), cur_(-1), lookahead_(HUGE_VAL), window_end_(-HUGE_VAL),
+	  windows_(0), critical_(0), violations_(0)
+{
+	add_lps(1);
+}
+
+PartitionedScheduler::~PartitionedScheduler()
+{
+	for (int i = 0; i < nlps_; i++)
+		delete lps_[i].queue_;
+	delete [] lps_;
+	delete [] cuts_;
+	delete [] entries_;
+}
+
+void
+PartitionedScheduler::add_lps(int n)
+{
+	if (n <= nlps_)
+		return;
+	LP* lps = new LP[n];
+	for (int i = 0; i < n; i++) {
+		if (i < nlps_) {
+			lps[i] = lps_[i];
+		} else {
+			lps[i].queue_ = new Heap;
+			lps[i].events_ = 0;
+			lps[i].window_events_ = 0;
+		}
+	}
+	delete [] lps_;
+	lps_ = lps;
+	nlps_ = n;
+}
+
+int
+PartitionedScheduler::lp_of(const Event* e) const
+{
+	if (nentries_ > 0) {
+		Entry key;
+		key.handler_ = e->handler_;
+		const Entry* begin = entries_;
+		const Entry* end = entries_ + nentries_;
+		const Entry* i = std::lower_bound(begin, end, key);
+		if (i != end && i->handler_ == e->handler_)
+			return (i->lp_);
+	}
+	return (lp_);
+}
+
+void
+PartitionedScheduler::insert(Event* e)
+{
+	int lp = lp_of(e);
+	if (cur_ >= 0 && lp != cur_ && e->time_ < window_end_)
+		violations_++;
+	lps_[lp].queue_->heap_insert(e->time_, (void*) e);
+}
+
+void
+PartitionedScheduler::cancel(Event* e)
+{
+	if (e->uid_ <= 0)
+		return;
+	e->uid_ = - e->uid_;
+	for (int i = 0; i < nlps_; i++)
+		if (lps_[i].queue_->heap_delete((void*) e))
+			return;
+}
+
+Event*
+PartitionedScheduler::lookup(scheduler_uid_t uid)
+{
+	for (int i = 0; i < nlps_; i++) {
+		Heap* q = lps_[i].queue_;
+		for (Event* e = (Event*) q->heap_iter_init(); e;
+		     e = (Event*) q->heap_iter())
+			if (e->uid_ == uid)
+				return (e);
+	}
+	return (0);
+}
+
+/*
+ * The LP holding the next event in global order, or -1.  Within an LP,
+ * the heap breaks ties in insertion order, which is uid order.
+ */
+int
+PartitionedScheduler::head_lp()
+{
+	int best = -1;
+	const Event* b = 0;
+	for (int i = 0; i < nlps_; i++) {
+		const Event* e = (const Event*) lps_[i].queue_->heap_min();
+		if (e == 0)
+			continue;
+		if (b == 0 || e->time_ < b->time_ ||
+		    (e->time_ == b->time_ && e->uid_ < b->uid_)) {
+			best = i;
+			b = e;
+		}
+	}
+	return (best);
+}
+
+const Event*
+PartitionedScheduler::head()
+{
+	int lp = head_lp();
+	if (lp < 0)
+		return (0);
+	return ((const Event*) lps_[lp].queue_->heap_min());
+}
+
+Event*
+PartitionedScheduler::deque()
+{
+	int lp = head_lp();
+	if (lp < 0)
+		return (0);
+	lp_ = lp;
+	return ((Event*) lps_[lp].queue_->heap_extract_min());
+}
+
+/*
+ * Packets crossing a cut are scheduled for the link's target, or for
+ * the link itself while it is dynamic (see LinkDelay::recv).  Both are
+ * looked up again at every run, since traces and dynamics are inserted
+ * after the link is created.
+ */
+void
+PartitionedScheduler::setup_cuts()
+{
+	delete [] entries_;
+	entries_ = new Entry[2 * ncuts_];
+	nentries_ = 0;
+	lookahead_ = HUGE_VAL;
+	for (int i = 0; i < ncuts_; i++) {
+		LinkDelay* link = cuts_[i].link_;
+		entries_[nentries_].handler_ = link;
+		entries_[nentries_++].lp_ = cuts_[i].lp_;
+		if (link->target() != 0) {
+			entries_[nentries_].handler_ = link->target();
+			entries_[nentries_++].lp_ = cuts_[i].lp_;
+		}
+		if (link->delay() < lookahead_)
+			lookahead_ = link->delay();
+	}
+	std::sort(entries_, entries_ + nentries_);
+}
+
+void
+PartitionedScheduler::end_window()
+{
+	long busiest = 0;
+	for (int i = 0; i < nlps_; i++) {
+		if (lps_[i].window_events_ > busiest)
+			busiest = lps_[i].window_events_;
+		lps_[i].window_events_ = 0;
+	}
+	if (busiest > 0) {
+		windows_++;
+		critical_ += busiest;
+	}
+}
+
+void
+PartitionedScheduler::run()
+{
+	instance_ = this;
+	setup_cuts();
+	Event *p;
+	while (!halted_ && (p = deque())) {
+		cur_ = lp_;
+		if (p->time_ >= window_end_) {
+			end_window();
+			window_end_ = p->time_ + lookahead_;
+		}
+		lps_[lp_].events_++;
+		lps_[lp_].window_events_++;
+		dispatch(p, p->time_);
+	}
+	end_window();
+	cur_ = -1;
+	lp_ = 0;
+}
+
+void
+PartitionedScheduler::reset()
+{
+	Scheduler::reset();
+	for (int i = 0; i < nlps_; i++) {
+		lps_[i].events_ = 0;
+		lps_[i].window_events_ = 0;
+	}
+	window_end_ = -HUGE_VAL;
+	windows_ = critical_ = violations_ = 0;
+}
+
+int
+PartitionedScheduler::command(int argc, const char*const* argv)
+{
+	Tcl& tcl = Tcl::instance();
+	if (argc == 2) {
+		if (strcmp(argv[1], "lp") == 0) {
+			tcl.resultf("%d", lp_);
+			return (TCL_OK);
+		}
+		if (strcmp(argv[1], "stats") == 0) {
+			char* buf = new char[128 + 24 * nlps_];
+			int n = sprintf(buf, "lookahead %.17g windows %ld "
+					"critical %ld violations %ld events {",
+					lookahead_, windows_, critical_,
+					violations_);
+			for (int i = 0; i < nlps_; i++)
+				n += sprintf(buf + n, i ? " %ld" : "%ld",
+					     lps_[i].events_);
+			sprintf(buf + n, "}");
+			tcl.result(buf);
+			delete [] buf;
+			return (TCL_OK);
+		}
+	} else if (argc == 3) {
+		/* LP of the events scheduled from Tcl, see "$ns at-lp" */
+		if (strcmp(argv[1], "lp") == 0) {
+			int lp = atoi(argv[2]);
+			if (lp < 0) {
+				tcl.resultf("Scheduler/Partitioned: bad LP %s",
+					    argv[2]);
+				return (TCL_ERROR);
+			}
+			add_lps(lp + 1);
+			lp_ = lp;
+			return (TCL_OK);
+		}
+	} else if (argc == 4) {
+		if (strcmp(argv[1], "cut") == 0) {
+			LinkDelay* link =
+				(LinkDelay*) TclObject::lookup(argv[2]);
+			int lp = atoi(argv[3]);
+			if (link == 0) {
+				tcl.resultf("Scheduler/Partitioned: "
+					    "no LinkDelay object %s", argv[2]);
+				return (TCL_ERROR);
+			}
+			if (lp < 0) {
+				tcl.resultf("Scheduler/Partitioned: bad LP %s",
+					    argv[3]);
+				return (TCL_ERROR);
+			}
+			add_lps(lp + 1);
+			for (int i = 0; i < ncuts_; i++) {
+				if (cuts_[i].link_ == link) {
+					cuts_[i].lp_ = lp;
+					return (TCL_OK);
+				}
+			}
+			Cut* cuts = new Cut[ncuts_ + 1];
+			for (int i = 0; i < ncuts_; i++)
+				cuts[i] = cuts_[i];
+			cuts[ncuts_].link_ = link;
+			cuts[ncuts_].lp_ = lp;
+			delete [] cuts_;
+			cuts_ = cuts;
+			ncuts_++;
+			return (TCL_OK);
+		}
+	}
+	return (Scheduler::command(argc, argv));
+}
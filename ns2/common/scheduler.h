@@ -217,5 +217,108 @@ private:
 	int validate(Event *);
 };
 
+class LadderScheduler : public Scheduler {
+public:
+	LadderScheduler();
+	~LadderScheduler();
+	void cancel(Event*);
+	void insert(Event*);
+	Event* lookup(scheduler_uid_t uid);
+	Event* deque();
+	const Event* head();
+
+protected:
+	enum {
+		MAX_RUNGS = 8,		// depth of the ladder
+		THRESHOLD = 50,		// bucket size that spawns a new rung
+		MAX_BUCKETS = 8192	// bucket count limit of a single rung
+	};
+
+	/* Buckets are circular lists headed by sentinel events. */
+	struct Rung {
+		Event* buckets_;
+		int capacity_;
+		int nbuckets_;
+		int cur_;		// first bucket not yet moved down
+		double start_;
+		double width_;
+	};
+
+	int bucket(const Rung&, double t) const;
+	void insert_bottom(Event*);
+	int spawn(Event* list, int n, double min, double max);
+	void sort_to_bottom(Event* list, int n);
+	void fill_bottom();
+
+	Event top_;		// unsorted events at or after top_start_
+	double top_start_;
+	Rung rungs_[MAX_RUNGS];
+	int nrungs_;
+	Event bottom_;		// sorted events due before all rungs
+	int nbottom_;		// events in Bottom, or more after a cancel
+	int recount_;		// nbottom_ may be high
+	int qsize_;
+
+	Event** scratch_;	// sort buffer for sort_to_bottom
+	int scratch_size_;
+};
+
+class LinkDelay;
+
+class PartitionedScheduler : public Scheduler {
+public:
+	PartitionedScheduler();
+	~PartitionedScheduler();
+	void run();
+	void cancel(Event*);
+	void insert(Event*);
+	Event* lookup(scheduler_uid_t uid);
+	Event* deque();
+	const Event* head();
+	void reset();
+
+protected:
+	int command(int argc, const char*const* argv);
+	void add_lps(int n);
+	int lp_of(const Event*) const;
+	int head_lp();
+	void setup_cuts();
+	void end_window();
+
+	/* A logical process: the events of the nodes assigned to it. */
+	struct LP {
+		Heap* queue_;
+		long events_;		// dispatched in all
+		long window_events_;	// dispatched in the current window
+	};
+	/* A link from one LP into another, and the LP it leads to. */
+	struct Cut {
+		LinkDelay* link_;
+		int lp_;
+	};
+	/* A handler whose events run in the LP at the far end of a cut. */
+	struct Entry {
+		Handler* handler_;
+		int lp_;
+		bool operator<(const Entry& e) const {
+			return (handler_ < e.handler_);
+		}
+	};
+
+	LP* lps_;
+	int nlps_;
+	Cut* cuts_;
+	int ncuts_;
+	Entry* entries_;	// sorted by handler_
+	int nentries_;
+	int lp_;		// LP of the events scheduled now
+	int cur_;		// LP of the event being dispatched, or -1
+	double lookahead_;	// smallest delay of a cut link
+	double window_end_;
+	long windows_;
+	long critical_;		// sum over windows of the busiest LP's events
+	long violations_;	// events for another LP inside the window
+};
+
 
 #endif
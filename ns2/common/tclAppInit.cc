@@ -17,6 +17,8 @@
 #include "config.h"
 
 extern void init_misc(void);
+extern void init_batch(void);
+extern int batch_options(int argc, char** argv);
 extern EmbeddedTcl et_ns_lib;
 extern EmbeddedTcl et_ns_ptypes;
 
@@ -64,6 +66,7 @@ EXTERN int		Tcltest_Init _ANSI_ARGS_((Tcl_Interp *interp));
 extern "C" int
 nslibmain(int argc, char **argv)
 {
+    argc = batch_options(argc, argv);
     Tcl_Main(argc, argv, Tcl_AppInit);
     return 0;			/* Needed only to prevent compiler warning. */
 }
@@ -257,6 +260,7 @@ Tcl_AppInit(Tcl_Interp *interp)
 	Tcl_SetVar(interp, "tcl_rcFileName", "~/.ns.tcl", TCL_GLOBAL_ONLY);
 	Tcl::init(interp, "ns");
 	init_misc();
+	init_batch();
         et_ns_ptypes.load();
 	et_ns_lib.load();
 
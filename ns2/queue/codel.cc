@@ -71,6 +71,16 @@ void CoDelQueue::reset()
     Queue::reset();
 }
 
+// A buffer handed over by another discipline keeps its enqueue timestamps,
+// so sojourn times and the control law pick up at the next dequeue.
+void CoDelQueue::transplanted(int received)
+{
+    if (received)
+        curq_ = q_->byteLength();
+    else
+        reset();
+}
+
 // Add a new packet to the queue.  The packet is dropped if the maximum queue
 // size in pkts is exceeded. Otherwise just add a timestamp so dequeue can
 // compute the sojourn time (all the work is done in the deque).
@@ -47,6 +47,7 @@ struct dodequeResult { Packet* p; int ok_to_drop; };
 class CoDelQueue : public Queue {
   public:   
     CoDelQueue();
+    bool can_transplant() const { return plain_packet_queue(); }
   protected:
     // Stuff specific to the CoDel algorithm
     void enque(Packet* pkt);
@@ -69,6 +70,7 @@ class CoDelQueue : public Queue {
     // NS-specific junk
     int command(int argc, const char*const* argv);
     void reset();
+    void transplanted(int received);
     void trace(TracedVar*); // routine to write trace records
 
     PacketQueue *q_;        // underlying FIFO queue
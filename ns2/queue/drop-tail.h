@@ -58,6 +58,7 @@ class DropTail : public Queue {
 	~DropTail() {
 		delete q_;
 	}
+	bool can_transplant() const { return plain_packet_queue(); }
   protected:
 	void reset();
 	int command(int argc, const char*const* argv); 
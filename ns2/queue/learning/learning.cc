@@ -3,8 +3,12 @@
 
 auto Learning::build(
         vector<Queue *> policies,
+        vector<Queue *> shadows,
+        LinkDelay const * link,
         shared_ptr<schad::learning::LearningMethodFactory> learning,
         Reward const& reward
         ) -> unique_ptr<Learning> {
-    return make_unique<LearningImpl>(move(policies), move(learning), reward);
+    return make_unique<LearningImpl>(
+        move(policies), move(shadows), link, move(learning), reward
+    );
 }
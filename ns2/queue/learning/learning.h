@@ -10,6 +10,8 @@
 #include <memory>
 #include <schad/learning/learning_method.h>
 
+class LinkDelay;
+
 struct IntervalEndListener {
     virtual void interval_ended() = 0;
 
@@ -23,6 +25,8 @@ struct IntervalEndListener {
 struct Learning {
     static auto build(
         vector<Queue *> policies, 
+        vector<Queue *> shadows,
+        LinkDelay const * link,
         shared_ptr<schad::learning::LearningMethodFactory> learning,
         Reward const& reward
     ) -> unique_ptr<Learning>;
@@ -31,6 +35,7 @@ struct Learning {
     virtual void set_reward_listener(RewardListener * listener) = 0;
 
     virtual void restart(IntervalParams const& params) = 0;
+    virtual void reset_shadows() = 0;
 
     virtual void note_arrival(Packet const * pkt) = 0;
     virtual void note_drop(Packet const * pkt) = 0;
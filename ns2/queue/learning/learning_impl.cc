@@ -36,10 +36,13 @@ private:
 
 LearningImpl::LearningImpl(
         vector<Queue *> policies, 
+        vector<Queue *> shadows,
+        LinkDelay const * link,
         shared_ptr<schad::learning::LearningMethodFactory> learning_factory,
         Reward const& reward
         ) 
     : policies_{move(policies)}
+    , shadows_{}
     , learning_factory_{move(learning_factory)}
     , learning_{}
     , interval_params_{}
@@ -52,7 +55,15 @@ LearningImpl::LearningImpl(
     , current_interval_idx_{0}
     , interval_end_listener_{nullptr}
     , reward_listener_{nullptr}
-{}
+{
+    reward_->reset(get_current()->peek_packets());
+    subreward_->reset(get_current()->peek_packets());
+    for (auto shadow : shadows) {
+        shadows_.push_back(
+            make_unique<ShadowPolicy>(shadow, link, reward)
+        );
+    }
+}
 
 LearningImpl::~LearningImpl() {
 
@@ -71,16 +82,25 @@ void LearningImpl::restart(IntervalParams const& params) {
     start_interval();
 }
 
+void LearningImpl::reset_shadows() {
+    for (auto& shadow : shadows_) {
+        shadow->reset();
+    }
+}
+
 void LearningImpl::start_interval() {
     if (is_current_interval_switch()) {
-        auto buffered = change_current(learning_->choose().front());
-        reward_->reset(vector<Packet const*>(begin(buffered), end(buffered)));
-    } else {
-        reward_->reset(get_current()->peek_packets());
+        change_current(learning_->choose().front());
+    }
+    reward_->restart();
+    for (auto i = 0u; i < shadows_.size(); ++i) {
+        if (i != current_policy_idx_) {
+            shadows_[i]->restart_reward();
+        }
     }
     interval_timer_->resched(interval_params_->interval());
 
-    subreward_->reset(get_current()->peek_packets());
+    subreward_->restart();
     subinterval_rewards_.clear();
     subinterval_timer_->resched(interval_params_->subinterval());
 }
@@ -90,6 +110,11 @@ void LearningImpl::finish_interval() {
         vector<optional<schad::Reward>> rewards(policies_.size(), nullopt);
 
         rewards[current_policy_idx_] = reward_->get_value();
+        for (auto i = 0u; i < shadows_.size(); ++i) {
+            if (i != current_policy_idx_) {
+                rewards[i] = shadows_[i]->get_reward();
+            }
+        }
         subinterval_rewards_.push_back(subreward_->get_value());
 
         learning_->report_rewards(rewards);
@@ -116,7 +141,7 @@ void LearningImpl::restart_interval() {
 void LearningImpl::save_subinterval_reward() {
     if (subinterval_rewards_.size() + 1 < interval_params_->num_subintervals()) {
         subinterval_rewards_.push_back(subreward_->get_value());
-        subreward_->reset(get_current()->peek_packets());
+        subreward_->restart();
     }
     if (subinterval_rewards_.size() + 1 < interval_params_->num_subintervals()) {
         subinterval_timer_->resched(interval_params_->subinterval());
@@ -127,12 +152,16 @@ auto LearningImpl::get_current() const -> Queue * {
     return policies_[current_policy_idx_];
 }
 
-auto LearningImpl::change_current(size_t new_idx) -> vector<Packet *> {
-    // TODO: what if the same
-    auto packets = utils::take_packets_and_reset(get_current());
+void LearningImpl::change_current(size_t new_idx) {
+    if (new_idx == current_policy_idx_) {
+        return;
+    }
+    if (!shadows_.empty()) {
+        shadows_[current_policy_idx_]->take_buffer_from(*shadows_[new_idx]);
+    }
+    auto const previous = get_current();
     current_policy_idx_ = new_idx;
-    utils::init_queue_with(get_current(), packets);
-    return packets;
+    utils::move_packets(previous, get_current());
 }
 
 auto LearningImpl::is_next_interval_switch() const -> bool {
@@ -159,6 +188,11 @@ void LearningImpl::write_reward_stats(ostream& out) const {
 void LearningImpl::note_arrival(Packet const * pkt) {
     reward_->note_arrival(pkt);
     subreward_->note_arrival(pkt);
+    for (auto i = 0u; i < shadows_.size(); ++i) {
+        if (i != current_policy_idx_) {
+            shadows_[i]->note_arrival(pkt);
+        }
+    }
 }
 
 void LearningImpl::note_drop(Packet const * pkt) {
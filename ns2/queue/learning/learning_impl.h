@@ -2,11 +2,14 @@
 #define NS_LEARNING_IMPL_H
 
 #include "learning.h"
+#include "shadow_policy.h"
 
 class LearningImpl : public Learning {
 public:
     LearningImpl(
         vector<Queue *> policies, 
+        vector<Queue *> shadows,
+        LinkDelay const * link,
         shared_ptr<schad::learning::LearningMethodFactory> learning,
         Reward const& reward
     );
@@ -16,6 +19,7 @@ public:
     void set_reward_listener(RewardListener * listener) override;
 
     void restart(IntervalParams const& params) override;
+    void reset_shadows() override;
 
     void note_arrival(Packet const * pkt) override;
     void note_drop(Packet const * pkt) override;
@@ -35,7 +39,7 @@ private:
     auto is_current_interval_switch() const -> bool;
     auto is_next_interval_switch() const -> bool;
 
-    auto change_current(size_t idx) -> vector<Packet *>;
+    void change_current(size_t idx);
 
     void finish_interval();
     void start_interval();
@@ -45,6 +49,7 @@ private:
 
 private:
     vector<Queue *> const policies_;
+    vector<unique_ptr<ShadowPolicy>> shadows_;
     shared_ptr<schad::learning::LearningMethodFactory> const learning_factory_;
 
     unique_ptr<schad::learning::LearningMethod> learning_;
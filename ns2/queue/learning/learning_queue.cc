@@ -1,5 +1,6 @@
 #include "config.h"
 #include "learning_queue.h"
+#include "delay.h"
 #include "utils/queue_utils.h"
 #include "interval_selection/fixed_interval_selector.h"
 
@@ -25,6 +26,8 @@ LearningQueue::LearningQueue()
 
       reward_{}, 
       policies_{}, 
+      shadows_{},
+      link_{nullptr},
 
       learning_channel_{nullptr},
       reward_channel_{nullptr},
@@ -45,6 +48,10 @@ void LearningQueue::reset() {
                       [this](auto p) { drop(p); });
     }
 
+    if (learning_) {
+        learning_->reset_shadows();
+    }
+
     if (!policies_.empty() && learning_) {
         //TODO: restart_interval();
     }
@@ -72,6 +79,15 @@ int LearningQueue::command(int argc, const char *const *argv) {
             add_policy(policy);
             return TCL_OK;
         }
+        if (strcmp(argv[1], "link") == 0) {
+            auto link = (LinkDelay*) TclObject::lookup(argv[2]);
+            if (link == nullptr) {
+                tcl.add_errorf("no LinkDelay object %s", argv[2]);
+                return TCL_ERROR;
+            }
+            link_ = link;
+            return TCL_OK;
+        }
         if (strcmp(argv[1], "set_reward") == 0) {
             auto reward = (Reward *) TclObject::lookup(argv[2]);
             if (reward == nullptr) {
@@ -98,6 +114,19 @@ int LearningQueue::command(int argc, const char *const *argv) {
         }
     }
 
+    if (argc == 4) {
+        if (strcmp(argv[1], "add_policy") == 0) {
+            auto policy = (Queue*) TclObject::lookup(argv[2]);
+            auto shadow = (Queue*) TclObject::lookup(argv[3]);
+            if (policy == nullptr || shadow == nullptr) {
+                tcl.add_errorf("no such object %s", policy ? argv[3] : argv[2]);
+                return TCL_ERROR;
+            }
+            add_policy(policy, shadow);
+            return TCL_OK;
+        }
+    }
+
     if (argc == 2) {
         if (strcmp(argv[1], "start_learning") == 0) {
             if (!learning_factory_) {
@@ -116,6 +145,14 @@ int LearningQueue::command(int argc, const char *const *argv) {
                 tcl.add_errorf("ERROR start_learning: no interval selector");
                 return TCL_ERROR;
             }
+            if (!shadows_.empty() && shadows_.size() != policies_.size()) {
+                tcl.add_errorf("ERROR start_learning: some policies have no shadow");
+                return TCL_ERROR;
+            }
+            if (!shadows_.empty() && link_ == nullptr) {
+                tcl.add_errorf("ERROR start_learning: no link for the shadows");
+                return TCL_ERROR;
+            }
             start_learning();
             return TCL_OK;
         }
@@ -147,13 +184,18 @@ Packet *LearningQueue::deque() {
     return nullptr;
 }
 
-void LearningQueue::add_policy(Queue *policy) {
+void LearningQueue::add_policy(Queue *policy, Queue *shadow) {
     auto& tcl = Tcl::instance();
 
     tcl.evalf("%s set limit_ %d", policy->name(), qlim_);
     policy->setDropTarget(&drop_proxy_);
 
     policies_.push_back(policy);
+
+    if (shadow != nullptr) {
+        tcl.evalf("%s set limit_ %d", shadow->name(), qlim_);
+        shadows_.push_back(shadow);
+    }
 }
 
 void LearningQueue::drop(Packet *pkt) {
@@ -165,8 +207,8 @@ void LearningQueue::drop(Packet *pkt) {
 }
 
 void LearningQueue::drop(Packet *pkt, const char *s) {
-    if (reward_) {
-        reward_->note_drop(pkt);
+    if (learning_) {
+        learning_->note_drop(pkt);
     }
 
     Queue::drop(pkt, s);
@@ -231,7 +273,9 @@ void LearningQueue::set_interval_selector(unique_ptr<IntervalSelector> selector)
 
 void LearningQueue::start_learning() {
     interval_selector_->reset(policies_.size());
-    learning_ = Learning::build(policies_, learning_factory_, *reward_);
+    learning_ = Learning::build(
+        policies_, shadows_, link_, learning_factory_, *reward_
+    );
     learning_->set_interval_end_listener(this);
     learning_->set_reward_listener(interval_selector_.get());
     learning_->restart(*interval_selector_->take_new_params());
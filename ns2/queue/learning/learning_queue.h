@@ -28,7 +28,7 @@ protected:
     int command(int argc, const char *const *argv) override;
 
 private:
-    void add_policy(Queue* policy);
+    void add_policy(Queue* policy, Queue* shadow = nullptr);
     void set_reward(Reward* reward);
     void set_interval_selector(unique_ptr<IntervalSelector> selector);
     void set_learning_factory(shared_ptr<schad::learning::LearningMethodFactory> factory);
@@ -55,6 +55,8 @@ private:
     shared_ptr<schad::learning::LearningMethodFactory> learning_factory_;
     Reward * reward_;
     vector<Queue *> policies_;
+    vector<Queue *> shadows_;
+    LinkDelay * link_;
 
     Tcl_Channel learning_channel_;
     Tcl_Channel reward_channel_;
@@ -8,6 +8,10 @@ void Reward::note_drop(Packet const * p) {
 
 }
 
+void Reward::restart() {
+    reset({});
+}
+
 void Reward::write_stats(ostream& out, size_t interval_idx) const {
 
 }
@@ -16,6 +16,8 @@ public:
     virtual auto get_value() const -> double = 0;
 
     virtual void reset(vector<Packet const*> packets) = 0;
+    // Starts a new interval over the buffer observed since the last reset
+    virtual void restart();
 
     virtual void write_stats(ostream& out, size_t interval_idx) const;
 
@@ -3,7 +3,11 @@
 #include "tcp.h"
 
 FlowStatistic::FlowStatistic()
-    :   flow_start_time_{Scheduler::instance().clock()}
+    :   FlowStatistic{Scheduler::instance().clock()} {
+}
+
+FlowStatistic::FlowStatistic(double start_time)
+    :   flow_start_time_{start_time}
     ,   num_packets_buffered_{0}
     ,   num_packets_transmitted_{0}
     ,   avg_delay_{0}
@@ -11,6 +15,14 @@ FlowStatistic::FlowStatistic()
     ,   last_transmission_time_{std::nullopt} {
 }
 
+void FlowStatistic::restart(double start_time) {
+    flow_start_time_ = start_time;
+    num_packets_transmitted_ = 0;
+    avg_delay_ = 0;
+    total_bytes_transmitted_ = 0;
+    last_transmission_time_ = std::nullopt;
+}
+
 void FlowStatistic::note_arrival(Packet const * packet) {
     num_packets_buffered_++;
 }
@@ -54,6 +66,10 @@ auto FlowStatistic::get_avg_delay() const -> double {
     return avg_delay_;
 }
 
+auto FlowStatistic::get_num_packets_buffered() const -> size_t {
+    return num_packets_buffered_;
+}
+
 auto FlowStatistic::get_total_bytes_transmitted() const -> size_t {
     return total_bytes_transmitted_;
 }
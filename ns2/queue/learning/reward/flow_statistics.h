@@ -7,6 +7,10 @@
 
 struct FlowStatistic {
     FlowStatistic();
+    explicit FlowStatistic(double start_time);
+
+    // Forgets everything but the packets still buffered
+    void restart(double start_time);
 
     void note_arrival(Packet const * packet);
     void note_drop(Packet const * packet);
@@ -16,12 +20,13 @@ struct FlowStatistic {
     auto get_active_interval(double interval) const -> double;
     auto get_throughput(double interval) const -> double;
     auto get_avg_delay() const -> double;
+    auto get_num_packets_buffered() const -> size_t;
 
 private:
     auto get_flow_end_time() const -> double;
 
 private:
-    double const flow_start_time_;
+    double flow_start_time_;
 
     size_t num_packets_buffered_;
     size_t num_packets_transmitted_;
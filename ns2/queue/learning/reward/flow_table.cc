@@ -0,0 +1,80 @@
+#include "flow_table.h"
+#include "scheduler.h"
+
+#include <algorithm>
+
+FlowTable::FlowTable()
+    : slots_{}, num_used_{0}, epoch_{1}, epoch_start_{0} {
+}
+
+void FlowTable::next_epoch(double start_time) {
+    epoch_++;
+    epoch_start_ = start_time;
+}
+
+void FlowTable::clear(double start_time) {
+    std::fill(begin(slots_), end(slots_), Slot{});
+    num_used_ = 0;
+    next_epoch(start_time);
+}
+
+auto FlowTable::get(FlowID flow) -> FlowStatistic& {
+    if (2 * (num_used_ + 1) > slots_.size()) {
+        auto const live = std::count_if(begin(slots_), end(slots_),
+                [this](auto const& slot) { return is_live(slot); });
+        auto capacity = std::max<size_t>(16, slots_.size());
+        while (4 * size_t(live + 1) > capacity) {
+            capacity *= 2;
+        }
+        rehash(capacity);
+    }
+
+    auto const now = Scheduler::instance().clock();
+    auto const mask = slots_.size() - 1;
+    Slot * reusable = nullptr;
+    auto i = home(flow);
+    for (; slots_[i].epoch != 0; i = (i + 1) & mask) {
+        auto& slot = slots_[i];
+        if (slot.flow == flow) {
+            if (slot.epoch != epoch_) {
+                auto const buffered = slot.stats.get_num_packets_buffered() > 0;
+                slot.stats.restart(buffered ? epoch_start_ : now);
+                slot.epoch = epoch_;
+            }
+            return slot.stats;
+        }
+        if (reusable == nullptr && !is_live(slot)) {
+            reusable = &slot;
+        }
+    }
+
+    if (reusable == nullptr) {
+        reusable = &slots_[i];
+        num_used_++;
+    }
+    *reusable = Slot{flow, epoch_, FlowStatistic{now}};
+    return reusable->stats;
+}
+
+auto FlowTable::home(FlowID flow) const -> size_t {
+    auto const hash = uint64_t(uint32_t(flow)) * 0x9E3779B97F4A7C15ull;
+    return size_t(hash >> 32) & (slots_.size() - 1);
+}
+
+void FlowTable::rehash(size_t capacity) {
+    std::vector<Slot> old(capacity);
+    swap(old, slots_);
+    num_used_ = 0;
+
+    auto const mask = capacity - 1;
+    for (auto const& slot : old) {
+        if (is_live(slot)) {
+            auto i = home(slot.flow);
+            while (slots_[i].epoch != 0) {
+                i = (i + 1) & mask;
+            }
+            slots_[i] = slot;
+            num_used_++;
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef NS_FLOW_TABLE_H
+#define NS_FLOW_TABLE_H
+
+#include "learning_common.h"
+#include "flow_statistics.h"
+
+#include <cstdint>
+#include <vector>
+
+// Open-addressing table of per-flow statistics. Every entry is stamped with
+// the epoch it was last touched in, so starting a new interval only bumps
+// the epoch; stale entries are restarted lazily when next touched and
+// buffered-packet counts carry over to the new interval.
+class FlowTable {
+public:
+    FlowTable();
+
+    void next_epoch(double start_time);
+    void clear(double start_time);
+
+    auto get(FlowID flow) -> FlowStatistic&;
+
+    // Visits flows that were touched in the current epoch or still have
+    // packets buffered, i.e. the flows present during the interval
+    template<class Func>
+    void for_each(Func f) const {
+        for (auto const& slot : slots_) {
+            if (slot.epoch == epoch_) {
+                f(slot.flow, slot.stats);
+            } else if (is_live(slot)) {
+                auto stats = slot.stats;
+                stats.restart(epoch_start_);
+                f(slot.flow, stats);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        FlowID flow{};
+        uint64_t epoch{0};      // 0 for a slot that was never used
+        FlowStatistic stats{0.0};
+    };
+
+private:
+    auto is_live(Slot const& slot) const -> bool {
+        return slot.epoch == epoch_ 
+            || (slot.epoch != 0 && slot.stats.get_num_packets_buffered() > 0);
+    }
+
+    auto home(FlowID flow) const -> size_t;
+    void rehash(size_t capacity);
+
+private:
+    std::vector<Slot> slots_;
+    size_t num_used_;
+    uint64_t epoch_;
+    double epoch_start_;
+};
+
+#endif // NS_FLOW_TABLE_H
@@ -29,69 +29,74 @@ PowerReward::PowerReward(double bandwidth,
 }
 
 void PowerReward::note_arrival(Packet const * p) {
-    if (flows_.find(HDR_IP(p)->flowid()) == end(flows_)) {
-        flows_.emplace(HDR_IP(p)->flowid(), FlowStatistic{});
-    }
-    flows_.at(HDR_IP(p)->flowid()).note_arrival(p);
+    flows_.get(HDR_IP(p)->flowid()).note_arrival(p);
 }
 
 void PowerReward::note_drop(Packet const * p) {
-    flows_.at(HDR_IP(p)->flowid()).note_drop(p);
+    flows_.get(HDR_IP(p)->flowid()).note_drop(p);
 }
 
 void PowerReward::note_transmission(Packet const * p) {
-    assert(flows_.count(HDR_IP(p)->flowid())); // TODO check that we are IP
-
-    flows_.at(HDR_IP(p)->flowid()).note_transmission(p);
+    flows_.get(HDR_IP(p)->flowid()).note_transmission(p);
 }
 
 auto PowerReward::get_value() const -> double {
-    if (flows_.size() == 0) {
+    auto const interval = get_interval();
+    size_t num_flows = 0;
+    size_t num_idle = 0;
+    double result = 0;
+
+    flows_.for_each([&](FlowID, FlowStatistic const& stats) {
+        auto const value = get_reward(interval, stats);
+        if (value.has_value()) {
+            result += *value;
+        } else {
+            num_idle++;
+        }
+        num_flows++;
+    });
+
+    if (num_flows == 0) {
         return 0.5;
     }
 
     auto const min_reward = 
-        log(min_bw_fraction_ * bandwidth_ / 8.0 / flows_.size()) 
+        log(min_bw_fraction_ * bandwidth_ / 8.0 / num_flows) 
             - delta_ * log(max_delay_);
     auto const max_reward = 
-        log(max_bw_fraction_ * bandwidth_ / 8.0 / flows_.size())
+        log(max_bw_fraction_ * bandwidth_ / 8.0 / num_flows)
             - delta_ * log(min_delay_);
 
-    double result = 0;
-    
-    for (auto const& [flow, stats] : flows_) {
-        auto const value = get_reward(get_interval(), stats);
-        if (value.has_value()) {
-            result += *value;
-        } else {
-            result += min_reward;
-        }
-    }
-
-    result /= flows_.size();
+    result += num_idle * min_reward;
+    result /= num_flows;
     result = (result - min_reward) / (max_reward - min_reward);
 
     return std::min(1.0, std::max(result, 0.0));
 }
 
 void PowerReward::write_stats(ostream& out, size_t interval_id) const {
-    for (auto const& [flow, stats] : flows_) {
+    flows_.for_each([&](FlowID flow, FlowStatistic const& stats) {
         out << interval_id << " " << flow  << " "
             << stats.get_total_bytes_transmitted() << " "
             << stats.get_active_interval(get_interval()) << " "
             << stats.get_avg_delay() << "\n";
-    }
+    });
 }
 
 void PowerReward::reset(vector<Packet const*> packets) {
     interval_start_ = Scheduler::instance().clock();
-    flows_.clear();
+    flows_.clear(interval_start_);
 
     for (auto const packet : packets) {
         note_arrival(packet);
     }
 }
 
+void PowerReward::restart() {
+    interval_start_ = Scheduler::instance().clock();
+    flows_.next_epoch(interval_start_);
+}
+
 auto PowerReward::get_reward(double interval, const FlowStatistic &stats) const
         -> std::optional<double> {
     double const throughput = stats.get_throughput(interval);
@@ -4,9 +4,7 @@
 #include "ip.h"
 
 #include "reward.h"
-#include "flow_statistics.h"
-
-#include <unordered_map>
+#include "flow_table.h"
 
 class PowerReward : public Reward {
 public:
@@ -24,6 +22,7 @@ public:
     auto get_value() const -> double override;
 
     void reset(vector<Packet const*> packets) override;
+    void restart() override;
 
     void write_stats(ostream& out, size_t interval_idx) const override;
 
@@ -43,7 +42,7 @@ private:
     double const delta_;
 
     double interval_start_;
-    std::unordered_map<FlowID, FlowStatistic> flows_;
+    FlowTable flows_;
 
     Tcl_Channel trace_channel_;
 };
@@ -0,0 +1,97 @@
+#include "shadow_policy.h"
+#include "timer-handler.h"
+#include "delay.h"
+
+#include "utils/queue_utils.h"
+
+class ShadowPolicy::ServiceTimer : public TimerHandler {
+public:
+    explicit ServiceTimer(ShadowPolicy * shadow) : shadow_{shadow} {}
+
+protected:
+    void expire(Event *event) override {
+        shadow_->serve();
+    }
+
+private:
+    ShadowPolicy * shadow_;
+};
+
+class ShadowPolicy::DropSink : public NsObject {
+public:
+    explicit DropSink(ShadowPolicy * shadow) : shadow_{shadow} {}
+
+    void recv(Packet* p, const char *s) override {
+        recv(p, static_cast<Handler *>(nullptr));
+    }
+
+    void recv(Packet* p, Handler * callback) override {
+        shadow_->reward_->note_drop(p);
+        Packet::free(p);
+    }
+
+private:
+    ShadowPolicy * shadow_;
+};
+
+ShadowPolicy::ShadowPolicy(Queue * queue, LinkDelay const * link, Reward const& reward)
+    : queue_{queue}
+    , link_{link}
+    , reward_{reward.clone()}
+    , service_timer_{make_unique<ServiceTimer>(this)}
+    , drop_sink_{make_unique<DropSink>(this)}
+{
+    queue_->setDropTarget(drop_sink_.get());
+    reward_->reset(queue_->peek_packets());
+}
+
+ShadowPolicy::~ShadowPolicy() {
+    stop();
+}
+
+void ShadowPolicy::note_arrival(Packet const * pkt) {
+    auto const copy = pkt->copy();
+    reward_->note_arrival(copy);
+    queue_->enque(copy);
+    if (service_timer_->status() != TimerHandler::TIMER_PENDING) {
+        serve();
+    }
+}
+
+void ShadowPolicy::take_buffer_from(ShadowPolicy& other) {
+    other.stop();
+    utils::move_packets(other.queue_, queue_);
+    reward_->reset(queue_->peek_packets());
+    if (service_timer_->status() != TimerHandler::TIMER_PENDING) {
+        serve();
+    }
+}
+
+void ShadowPolicy::reset() {
+    stop();
+    for (auto pkt : utils::take_packets_and_reset(queue_)) {
+        drop_sink_->recv(pkt, static_cast<Handler *>(nullptr));
+    }
+}
+
+void ShadowPolicy::restart_reward() {
+    reward_->restart();
+}
+
+auto ShadowPolicy::get_reward() const -> double {
+    return reward_->get_value();
+}
+
+void ShadowPolicy::serve() {
+    auto const pkt = queue_->deque();
+    if (pkt == nullptr) {
+        return;
+    }
+    reward_->note_transmission(pkt);
+    service_timer_->resched(8.0 * HDR_CMN(pkt)->size() / link_->bandwidth());
+    Packet::free(pkt);
+}
+
+void ShadowPolicy::stop() {
+    service_timer_->force_cancel();
+}
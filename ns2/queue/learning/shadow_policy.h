@@ -0,0 +1,48 @@
+#ifndef NS_SHADOW_POLICY_H
+#define NS_SHADOW_POLICY_H
+
+#include "learning_common.h"
+#include "queue.h"
+#include "reward.h"
+
+#include <memory>
+
+class LinkDelay;
+
+// Runs a second instance of a policy on copies of the real arrivals and
+// serves it at the link's current rate without transmitting anything, so
+// that its reward is known even while it is not the active policy.
+class ShadowPolicy {
+public:
+    ShadowPolicy(Queue * queue, LinkDelay const * link, Reward const& reward);
+    ~ShadowPolicy();
+
+    ShadowPolicy(ShadowPolicy const&) = delete;
+    ShadowPolicy& operator=(ShadowPolicy const&) = delete;
+
+    void note_arrival(Packet const * pkt);
+
+    void take_buffer_from(ShadowPolicy& other);
+
+    void reset();
+
+    void restart_reward();
+    auto get_reward() const -> double;
+
+private:
+    class ServiceTimer;
+    class DropSink;
+
+private:
+    void serve();
+    void stop();
+
+private:
+    Queue * const queue_;
+    LinkDelay const * const link_;
+    unique_ptr<Reward> const reward_;
+    unique_ptr<ServiceTimer> const service_timer_;
+    unique_ptr<DropSink> const drop_sink_;
+};
+
+#endif // NS_SHADOW_POLICY_H
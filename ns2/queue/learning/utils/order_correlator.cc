@@ -1,79 +1,121 @@
 #include "order_correlator.h"
 
 #include <algorithm>
-#include <numeric>
-#include <map>
+#include <stdexcept>
 #include <cmath>
 
 OrderCorrelator::OrderCorrelator(size_t min_samples)
     : min_samples_{min_samples}
     , samples_{}
+    , values_{}
+    , counts_{}
+    , tree_{}
+    , num_concordant_{0}
+    , num_discordant_{0}
+    , ties_{}
 {}
 
 void OrderCorrelator::add_sample(double a, double b) {
-    samples_[0].push_back(round(a * 100));
-    samples_[1].push_back(round(b * 100));
+    std::array<double, 2> const sample{round(a * 100), round(b * 100)};
+
+    auto const [rx, new_x] = rank(0, sample[0]);
+    auto const [ry, new_y] = rank(1, sample[1]);
+    if (new_x || new_y) {
+        rebuild();
+    }
+
+    auto const n = int64_t(samples_.size());
+    auto const dx = values_[0].size();
+    auto const dy = values_[1].size();
+
+    auto const less_less = count(rx, ry);
+    auto const greater_greater = 
+        n - count(rx + 1, dy) - count(dx, ry + 1) + count(rx + 1, ry + 1);
+    auto const less_greater = count(rx, dy) - count(rx, ry + 1);
+    auto const greater_less = count(dx, ry) - count(rx + 1, ry);
+
+    num_concordant_ += less_less + greater_greater;
+    num_discordant_ += less_greater + greater_less;
+    ties_[0] += counts_[0][rx]++;
+    ties_[1] += counts_[1][ry]++;
+
+    add_point(rx, ry);
+    samples_.push_back(sample);
 }
 
 auto OrderCorrelator::get_result() const -> std::optional<double> {
-    if (samples_[0].size() < min_samples_) {
+    if (samples_.size() < min_samples_) {
         return std::nullopt;
-    } else {
-        return get_correlation(samples_[0], samples_[1]);
     }
-}
 
+    auto const n = double(samples_.size());
+    auto const cnt = n * (n - 1) / 2;
+    auto const ties_x = double(ties_[0]);
+    auto const ties_y = double(ties_[1]);
 
-auto OrderCorrelator::get_correlation(
-        std::vector<double> const& xs,
-        std::vector<double> const& ys
-        ) -> double 
-{
-    auto num_concordant = 0;
-    auto num_discordant = 0;
-    std::map<double, size_t> x_groups;
-    std::map<double, size_t> y_groups;
-    for (auto i = 0; i < int(xs.size()); i++) {
-        auto const xi = xs[i];
-        x_groups[xi]++;
-        auto const yi = ys[i];
-        y_groups[yi]++;
-        for (auto j = i + 1; j < int(ys.size()); j++) {
-            auto const xj = xs[j];
-            auto const yj = ys[j];
-
-            if ((xi < xj && yi < yj) || (xi > xj && yi > yj)) {
-                num_concordant++;
-            }
-            if ((xi > xj && yi < yj) || (xi < xj && yi > yj)) {
-                num_discordant++;
-            }
-        }
+    if (cnt == ties_y) {
+        return ties_x / cnt;
+    }
+    if (cnt == ties_x) {
+        return ties_y / cnt;
     }
-    int const cnt_x = xs.size() * (xs.size() - 1) / 2;
-    int const cnt_y = ys.size() * (ys.size() - 1) / 2;
 
-    auto ties_x = 0;
-    for (auto [x, cnt] : x_groups) {
-        ties_x += cnt * (cnt - 1) / 2;
+    auto result = (num_concordant_ - num_discordant_) 
+        / sqrt((cnt - ties_x) * (cnt - ties_y));
+    if (result != result) {
+        throw std::logic_error("NaN correlation is bad");
     }
-    auto ties_y = 0;
-    for (auto [y, cnt] : y_groups) {
-        ties_y += cnt * (cnt - 1) / 2;
+    return result;
+}
+
+auto OrderCorrelator::rank(size_t coord, double value) 
+        -> std::pair<size_t, bool> {
+    auto& values = values_[coord];
+    auto const it = std::lower_bound(begin(values), end(values), value);
+    auto const idx = size_t(it - begin(values));
+    if (it != end(values) && *it == value) {
+        return {idx, false};
     }
+    values.insert(it, value);
+    return {idx, true};
+}
 
-    if (cnt_y == ties_y) {
-        return ties_x / (double) cnt_x;
+void OrderCorrelator::rebuild() {
+    for (auto coord : {0, 1}) {
+        counts_[coord].assign(values_[coord].size(), 0);
     }
-    
-    if (cnt_x == ties_x) {
-        return ties_y / (double) cnt_y;
+    tree_.assign(values_[0].size() * values_[1].size(), 0);
+
+    for (auto const& sample : samples_) {
+        std::array<size_t, 2> ranks{};
+        for (auto coord : {0, 1}) {
+            auto const& values = values_[coord];
+            ranks[coord] = std::lower_bound(begin(values), end(values), sample[coord])
+                - begin(values);
+            counts_[coord][ranks[coord]]++;
+        }
+        add_point(ranks[0], ranks[1]);
     }
+}
 
-    auto result = (num_concordant - num_discordant) 
-        / (double) sqrt((cnt_x - ties_x) * (cnt_y - ties_y));
-    if (result != result) {
-        throw std::logic_error("NaN correlation is bad");
+void OrderCorrelator::add_point(size_t rx, size_t ry) {
+    auto const dx = values_[0].size();
+    auto const dy = values_[1].size();
+    for (auto i = rx + 1; i <= dx; i += i & -i) {
+        for (auto j = ry + 1; j <= dy; j += j & -j) {
+            tree_[(i - 1) * dy + (j - 1)]++;
+        }
+    }
+}
+
+// Number of samples with x rank below rx and y rank below ry
+auto OrderCorrelator::count(size_t rx, size_t ry) const -> int64_t {
+    auto const dy = values_[1].size();
+    int64_t result = 0;
+    for (auto i = rx; i > 0; i -= i & -i) {
+        for (auto j = ry; j > 0; j -= j & -j) {
+            result += tree_[(i - 1) * dy + (j - 1)];
+        }
     }
     return result;
 }
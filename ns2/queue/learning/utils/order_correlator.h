@@ -4,7 +4,12 @@
 #include <optional>
 #include <vector>
 #include <array>
+#include <cstdint>
 
+// Kendall's tau-b of the reported sample pairs, maintained incrementally.
+// Samples are rounded to hundredths, so the number of distinct values per
+// coordinate stays small; a 2D Fenwick tree over their ranks counts the
+// concordant and discordant pairs each new sample forms in O(log^2 d).
 class OrderCorrelator {
 public:
     OrderCorrelator(size_t min_samples);
@@ -12,15 +17,25 @@ public:
     void add_sample(double a, double b);
 
     auto get_result() const -> std::optional<double>;
+
 private:
-    static auto get_correlation(
-            std::vector<double> const& xs,
-            std::vector<double> const& ys) -> double;
+    auto rank(size_t coord, double value) -> std::pair<size_t, bool>;
+    void rebuild();
+
+    void add_point(size_t rx, size_t ry);
+    auto count(size_t rx, size_t ry) const -> int64_t;
 
 private:
     size_t const min_samples_;
 
-    std::array<std::vector<double>, 2> samples_;
+    std::vector<std::array<double, 2>> samples_;
+    std::array<std::vector<double>, 2> values_;
+    std::array<std::vector<size_t>, 2> counts_;
+    std::vector<uint32_t> tree_;
+
+    int64_t num_concordant_;
+    int64_t num_discordant_;
+    std::array<int64_t, 2> ties_;
 };
 
 #endif // NS_ORDER_CORRELATOR_H
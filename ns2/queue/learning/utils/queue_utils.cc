@@ -34,3 +34,11 @@ void utils::init_queue_with(Queue * queue, vector<Packet *> const& packets) {
         HDR_CMN(packet)->ts_ = saved_timestamp;
     }
 }
+
+void utils::move_packets(Queue * from, Queue * to) {
+    if (from->can_transplant() && to->can_transplant()) {
+        from->transplant_to(to);
+    } else {
+        init_queue_with(to, take_packets_and_reset(from));
+    }
+}
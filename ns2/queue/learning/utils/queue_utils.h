@@ -8,6 +8,7 @@ namespace utils {
 
 auto take_packets_and_reset(Queue * queue) -> vector<Packet *>;
 void init_queue_with(Queue * queue, vector<Packet *> const& packets);
+void move_packets(Queue * from, Queue * to);
 
 }
 
@@ -40,6 +40,7 @@ static const char rcsid[] =
 #include "queue.h"
 #include <math.h>
 #include <stdio.h>
+#include <typeinfo>
 
 void PacketQueue::remove(Packet* target)
 {
@@ -236,6 +237,26 @@ void Queue::reset()
 		drop(p);
 }
 
+int Queue::plain_packet_queue() const
+{
+	return (pq_ != 0 && typeid(*pq_) == typeid(PacketQueue));
+}
+
+void Queue::transplant_to(Queue* target)
+{
+	assert(can_transplant() && target->can_transplant());
+	assert(target->length() == 0);
+	target->pq_->append(*pq_);
+	transplanted(0);
+	target->transplanted(1);
+}
+
+void Queue::transplanted(int received)
+{
+	if (!received)
+		reset();
+}
+
 vector<Packet const *> Queue::peek_packets() const {
     if (!pq_) {
         return vector<Packet const *>();
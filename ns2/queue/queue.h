@@ -90,6 +90,17 @@ public:
 		++len_;
 		bytes_ += hdr_cmn::access(p)->size();
 	}
+	/* move every packet of q to the tail of this queue in O(1) */
+	void append(PacketQueue& q) {
+		if (!q.head_) return;
+		if (!tail_) head_ = q.head_;
+		else tail_->next_ = q.head_;
+		tail_ = q.tail_;
+		len_ += q.len_;
+		bytes_ += q.bytes_;
+		q.head_ = q.tail_ = q.iter = 0;
+		q.len_ = q.bytes_ = 0;
+	}
         void resetIterator() {iter = head_;}
         Packet* getNext() { 
 	        if (!iter) return 0;
@@ -140,6 +151,11 @@ public:
 	virtual double utilization (void);
     virtual vector<Packet const* > peek_packets() const;
 
+	/* Whole-buffer handoff between disciplines. Only queues keeping
+	 * their packets in a plain FIFO pq_ may opt in. */
+	virtual bool can_transplant() const { return false; }
+	void transplant_to(Queue* target);
+
 	/* max utilization over recent time period.
 	   Returns the maximum of recent measurements stored in util_buf_*/
 	double peak_utilization(void);
@@ -147,6 +163,10 @@ public:
 protected:
 	Queue();
 	void reset();
+	int plain_packet_queue() const;
+	/* called on both queues after transplant_to(); the giving queue
+	 * resets by default, the receiving one rebuilds lazily */
+	virtual void transplanted(int received);
 	int qlim_;		/* maximum allowed pkts in queue */
 	int blocked_;		/* blocked now? */
 	int unblock_on_resume_;	/* unblock q on idle? */
@@ -265,6 +265,16 @@ void REDQueue::initParams()
 }
 
 
+/*
+ * The giving queue forgets its average and drop count, as it did when
+ * it was reset through Tcl.
+ */
+void REDQueue::transplanted(int received)
+{
+	if (!received)
+		reset();
+}
+
 void REDQueue::reset()
 {
 	
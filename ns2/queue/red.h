@@ -143,6 +143,7 @@ class REDQueue : public Queue {
  public:	
 	/*	REDQueue();*/
 	REDQueue(const char * = "Drop");
+	bool can_transplant() const { return plain_packet_queue(); }
  protected:
 	void initParams();
 	int command(int argc, const char*const* argv);
@@ -152,6 +153,7 @@ class REDQueue : public Queue {
 	Packet* deque();
 	void initialize_params();
 	void reset();
+	void transplanted(int received);
 	void run_estimator(int nqueued, int m);	/* Obsolete */
 	double estimator(int nqueued, int m, double ave, double q_w);
 	void updateMaxP(double new_ave, double now);
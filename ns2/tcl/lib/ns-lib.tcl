@@ -281,6 +281,54 @@ Simulator instproc use-scheduler type {
 	$scheduler_ now
 }
 
+#
+# Logical processes for Scheduler/Partitioned.  Nodes are in LP 0 unless
+# set otherwise; links between nodes in different LPs are cut at "run".
+#
+Simulator instproc set-lp { node lp } {
+	$self instvar lp_
+	set lp_([$node id]) $lp
+}
+
+Simulator instproc get-lp { id } {
+	$self instvar lp_
+	if [info exists lp_($id)] {
+		return $lp_($id)
+	}
+	return 0
+}
+
+# Like "at", but the event and those it schedules run in LP $lp.
+Simulator instproc at-lp { lp args } {
+	$self instvar scheduler_
+	if { [$scheduler_ info class] != "Scheduler/Partitioned" } {
+		return [eval $self at $args]
+	}
+	set saved [$scheduler_ lp]
+	$scheduler_ lp $lp
+	set ev [eval $self at $args]
+	$scheduler_ lp $saved
+	return $ev
+}
+
+Simulator instproc partition-links {} {
+	$self instvar scheduler_ link_
+	foreach ln [array names link_] {
+		set ids [split $ln :]
+		set from [$self get-lp [lindex $ids 0]]
+		set to [$self get-lp [lindex $ids 1]]
+		if { $from == $to } {
+			continue
+		}
+		set dl [$link_($ln) link]
+		if { [lsearch [concat [$dl info class] \
+		    [[$dl info class] info heritage]] DelayLink] < 0 } {
+			error "partition-links: $ln is not a simple link"
+		}
+		$scheduler_ cut $dl $to
+	}
+}
+
 Simulator instproc delay_parse { spec } {
 	return [time_parse $spec]
 }
@@ -1002,6 +1050,10 @@ Simulator instproc run {} {
 	# Do all nam-related initialization here
 	$self init-nam
 
+	if { [$scheduler_ info class] == "Scheduler/Partitioned" } {
+		$self partition-links
+	}
+
 	# NIXVECTOR xxx?
 	# global simstart
 	# set simstart [clock seconds]
@@ -1119,7 +1171,8 @@ Simulator instproc simplex-link { n1 n2 bw delay qtype args } {
 	    [string first "REM" $qtype] != -1 ||  
 	    [string first "GK" $qtype] != -1 ||  
 	    [string first "RIO" $qtype] != -1 ||
-	    [string first "XCP" $qtype] != -1} {
+	    [string first "XCP" $qtype] != -1 ||
+	    [string first "Learning" $qtype] != -1} {
 		$q link [$link_($sid:$did) set link_]
 	}
 
@@ -1509,6 +1562,21 @@ Simulator instproc trace-queue { n1 n2 {file ""} } {
 	$queue attach-traces $n1 $n2 $file
 }
 
+#
+# write enqueue, dequeue and drop events of the link between n1 and n2
+# to the binary file at path (see trace/binary-queue-trace.h)
+#
+Simulator instproc trace-queue-binary { n1 n2 path } {
+	$self instvar link_
+	set link $link_([$n1 id]:[$n2 id])
+	set bt [new BinaryQueueTrace $path]
+	$link trace $self ""
+	foreach t [list [$link set enqT_] [$link set deqT_] [$link set drpT_]] {
+		$t binary-attach $bt
+	}
+	return $bt
+}
+
 #
 # arrange for queue length of link between nodes n1 and n2
 # to be tracked and return object that can be queried
@@ -0,0 +1,100 @@
+# This test suite runs a partitioned topology, so that its trace can be
+# compared between Scheduler/Partitioned and a sequential scheduler.
+#
+# To run all tests:  test-all-partitioned
+#
+# To run individual tests:
+# ns test-suite-partitioned.tcl List
+# ns test-suite-partitioned.tcl Partitioned
+#
+remove-all-packet-headers       ; # removes all except common
+add-packet-header Flags IP TCP  ; # hdrs reqd for validation test
+
+# What does this test do?
+#   - it builds a dumbbell whose sources, right router and sinks are in
+#     three logical processes, so that the bottleneck and the sink links
+#     are cut.
+#   - two TCP flows cross it from left to right and a CBR flow from
+#     right to left.  Every link is traced to stdout.
+#   - test-all-partitioned compares that trace with the one written
+#     under Scheduler/List.  They must be identical.
+#   - under Scheduler/Partitioned it also checks that every LP ran
+#     events and that no event was scheduled for another LP within the
+#     lookahead, and writes the scheduler's statistics to stderr.
+#   - if a check fails it exits with status 1, otherwise with status 0.
+
+proc fail { msg } {
+	puts stderr "FAILED: $msg"
+	exit 1
+}
+
+proc finish {} {
+	global ns scheduler
+	$ns flush-trace
+	if { $scheduler == "Partitioned" } {
+		set s [[$ns set scheduler_] stats]
+		puts stderr "Partitioned: $s"
+		array set stats $s
+		if { $stats(violations) != 0 } {
+			fail "$stats(violations) events broke the lookahead"
+		}
+		if { [llength $stats(events)] != 3 } {
+			fail "expected 3 LPs, got $stats(events)"
+		}
+		foreach e $stats(events) {
+			if { $e == 0 } {
+				fail "an LP ran no events: $stats(events)"
+			}
+		}
+	}
+	exit 0
+}
+
+proc usage {} {
+	global argv0
+	puts stderr "usage: ns $argv0 <scheduler>"
+	exit 1
+}
+
+global argc argv
+if { $argc == 1 } {
+	set scheduler [lindex $argv 0]
+} else {
+	usage
+}
+
+set ns [new Simulator]
+if { [catch "$ns use-scheduler $scheduler"] } {
+	puts "*** WARNING: scheduler Scheduler/$scheduler is not supported, test was not run"
+	exit 0
+}
+$ns trace-all stdout
+
+foreach n {s0 s1 r0 r1 k0 k1} {
+	set node($n) [$ns node]
+}
+$ns set-lp $node(r1) 1
+$ns set-lp $node(k0) 2
+$ns set-lp $node(k1) 2
+
+$ns duplex-link $node(s0) $node(r0) 10Mb 2ms DropTail
+$ns duplex-link $node(s1) $node(r0) 10Mb 3ms DropTail
+$ns duplex-link $node(r0) $node(r1) 1.5Mb 10ms DropTail
+$ns duplex-link $node(r1) $node(k0) 10Mb 4ms DropTail
+$ns duplex-link $node(r1) $node(k1) 10Mb 5ms DropTail
+$ns queue-limit $node(r0) $node(r1) 20
+
+set tcp0 [$ns create-connection TCP/Reno $node(s0) TCPSink/DelAck $node(k0) 0]
+set ftp0 [$tcp0 attach-app FTP]
+set tcp1 [$ns create-connection TCP/Sack1 $node(s1) TCPSink/Sack1 $node(k1) 1]
+set ftp1 [$tcp1 attach-app FTP]
+set udp [$ns create-connection UDP $node(k1) Null $node(s0) 2]
+set cbr [$udp attach-app Traffic/CBR]
+$cbr set packetSize_ 200
+$cbr set interval_ 0.013
+
+$ns at-lp 0 0.0 "$ftp0 start"
+$ns at-lp 0 0.1 "$ftp1 start"
+$ns at-lp 2 0.2 "$cbr start"
+$ns at 5.0 "finish"
+$ns run
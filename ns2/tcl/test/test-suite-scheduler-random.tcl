@@ -0,0 +1,155 @@
+# This test suite checks a scheduler against the reference event order
+# on a randomized workload.
+#
+# To run all tests:  test-all-scheduler-random
+#
+# To run individual tests:
+# ns test-suite-scheduler-random.tcl List
+# ns test-suite-scheduler-random.tcl Ladder
+#
+remove-all-packet-headers       ; # removes all except common
+add-packet-header Flags IP TCP  ; # hdrs reqd for validation test
+
+# What does this test do?
+#   - it schedules $INITIAL events at random times.  All times are
+#     multiples of 1/$GRID, so that many events coincide and sums of
+#     times are exact.
+#   - when an event fires, it checks that it is due now and that it
+#     comes after the previous one in the reference order: by time, and
+#     in the order they were scheduled for events at the same time.
+#   - it then schedules more events, now or later, occasionally a burst
+#     of $BURST of them close together, and cancels a pending event at
+#     random, until $LIMIT events have been scheduled.
+#   - at the end, every event that was not cancelled must have fired
+#     exactly once.
+#   - each event is put into one of $LPS logical processes at random,
+#     which only Scheduler/Partitioned looks at.  That scheduler must
+#     also have counted every event that fired.
+#   - if any check fails it exits with status 1, otherwise with status 0.
+
+set INITIAL 2000	;# events scheduled before the run
+set LIMIT 30000		;# events scheduled in all
+set BURST 200		;# events in a burst
+set GRID 64		;# time resolution
+set LPS 4		;# logical processes for Scheduler/Partitioned
+
+proc fail { msg } {
+	puts stderr "FAILED: $msg"
+	exit 1
+}
+
+proc schedule { t } {
+	global ns rng time uid pending nevents LPS
+	set n $nevents
+	incr nevents
+	set time($n) $t
+	set uid($n) [$ns at-lp [$rng integer $LPS] $t "fire $n"]
+	set pending($n) 1
+}
+
+proc cancel-random {} {
+	global ns rng uid pending nevents ncancelled
+	set n [$rng integer $nevents]
+	if [info exists pending($n)] {
+		$ns cancel $uid($n)
+		unset pending($n)
+		incr ncancelled
+	}
+}
+
+proc fire { n } {
+	global ns rng time pending nevents nfired last quiet
+	global LIMIT BURST GRID
+
+	if ![info exists pending($n)] {
+		fail "event $n fired although it was not pending"
+	}
+	unset pending($n)
+	set now [$ns now]
+	if { $now != $time($n) } {
+		fail "event $n due at $time($n) fired at $now"
+	}
+	set t [lindex $last 0]
+	if { $time($n) < $t || ($time($n) == $t && $n < [lindex $last 1]) } {
+		fail "event $n at $time($n) fired after event [lindex $last 1] at $t"
+	}
+	set last [list $time($n) $n]
+	incr nfired
+	if { $quiet != "QUIET" } {
+		puts "$now $n"
+	}
+
+	if { $nevents < $LIMIT } {
+		set r [$rng uniform 0 1]
+		if { $r < 0.01 } {
+			for {set i 0} {$i < $BURST} {incr i} {
+				schedule [expr $now + [$rng integer 4] / double($GRID)]
+			}
+		} elseif { $r < 0.3 } {
+			schedule $now
+		} else {
+			schedule [expr $now + [$rng integer [expr 4 * $GRID]] / double($GRID)]
+		}
+		if { [$rng uniform 0 1] < 0.5 } {
+			schedule [expr $now + [$rng integer [expr 4 * $GRID]] / double($GRID)]
+		}
+	}
+	if { [$rng uniform 0 1] < 0.4 } {
+		cancel-random
+	}
+}
+
+proc usage {} {
+	global argv0
+	puts stderr "usage: ns $argv0 <scheduler> \[quiet\]"
+	exit 1
+}
+
+global argc argv
+set quiet ""
+if { $argc == 2 } {
+	set quiet [lindex $argv 1]
+	if { $quiet != "QUIET" && $quiet != "quiet" } {
+		usage
+	}
+	set quiet "QUIET"
+}
+if { $argc > 0 && $argc < 3 } {
+	set scheduler [lindex $argv 0]
+} else {
+	usage
+}
+
+set ns [new Simulator]
+if { [catch "$ns use-scheduler $scheduler"] } {
+	puts "*** WARNING: scheduler Scheduler/$scheduler is not supported, test was not run"
+	exit 0
+}
+set rng [new RNG]
+set nevents 0
+set nfired 0
+set ncancelled 0
+set last [list 0 -1]
+
+for {set i 0} {$i < $INITIAL} {incr i} {
+	schedule [expr [$rng integer [expr 16 * $GRID]] / double($GRID)]
+}
+for {set i 0} {$i < $INITIAL / 10} {incr i} {
+	cancel-random
+}
+$ns run
+
+if { $nfired + $ncancelled != $nevents } {
+	fail "$nevents events scheduled, $nfired fired, $ncancelled cancelled"
+}
+if { $scheduler == "Partitioned" } {
+	array set stats [[$ns set scheduler_] stats]
+	set n 0
+	foreach e $stats(events) {
+		incr n $e
+	}
+	if { $n != $nfired || [llength $stats(events)] != $LPS } {
+		fail "Partitioned counted $stats(events) events, $nfired fired"
+	}
+}
+exit 0
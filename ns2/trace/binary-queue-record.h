@@ -0,0 +1,54 @@
+/* -*-	Mode:C++; c-basic-offset:8; tab-width:8; indent-tabs-mode:t -*- */
+/*
+ * On-disk format of the binary queue trace, shared by the writer in ns
+ * and the stand-alone queue-trace-text converter.
+ *
+ * File layout: a BinaryQueueTraceHeader, the names of the first ntypes
+ * packet types as NUL-terminated strings, padding up to data_offset,
+ * then BinaryQueueEvent records in simulation order.
+ */
+
+#ifndef ns_binary_queue_record_h
+#define ns_binary_queue_record_h
+
+#include <stdint.h>
+
+#define BINARY_QUEUE_TRACE_MAGIC "NSQUEUE"
+#define BINARY_QUEUE_TRACE_VERSION 2
+
+// characters of the text trace's flags field, one per bit of flags
+#define BINARY_QUEUE_TRACE_FLAGS "CP-AEFN"
+
+struct BinaryQueueTraceHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t record_size;
+	uint32_t data_offset;	// records start here
+	uint32_t ntypes;	// packet type names following the header
+};
+
+// must match tracing.QueueTrace.DTYPE
+struct BinaryQueueEvent {
+	enum { ENQUEUE = 1, DEQUEUE = 2, DROP = 3 };
+
+	uint16_t event;
+	uint16_t size;
+	uint16_t src;
+	uint16_t dst;
+	double ts;
+	uint64_t id;
+	uint64_t flow_id;
+	double delay;
+
+	// only needed to reproduce the text trace
+	uint16_t from_node;	// link endpoints
+	uint16_t to_node;
+	uint16_t ptype;
+	uint16_t flags;
+	int32_t sport;
+	int32_t dport;
+	int32_t seqno;
+	uint32_t pad;
+};
+
+#endif
@@ -0,0 +1,293 @@
+/* -*-	Mode:C++; c-basic-offset:8; tab-width:8; indent-tabs-mode:t -*- */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <limits>
+
+#include "ip.h"
+#include "flags.h"
+#include "address.h"
+#include "scheduler.h"
+#include "binary-queue-trace.h"
+
+static class BinaryQueueTraceClass : public TclClass {
+public:
+	BinaryQueueTraceClass() : TclClass("BinaryQueueTrace") { }
+	TclObject* create(int argc, const char*const* argv) {
+		if (argc < 5)
+			return 0;
+		BinaryQueueTrace* t = new BinaryQueueTrace(argv[4]);
+		if (!t->is_open()) {
+			delete t;
+			return 0;
+		}
+		return t;
+	}
+} binary_queue_trace_class;
+
+BinaryQueueTrace* BinaryQueueTrace::open_;
+
+/* write(2) all of buf, returning 0 or an errno */
+static int
+write_all(int fd, const char* buf, size_t len)
+{
+	while (len > 0) {
+		ssize_t n = ::write(fd, buf, len);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return errno;
+		}
+		buf += n;
+		len -= n;
+	}
+	return 0;
+}
+
+BinaryQueueTrace::BinaryQueueTrace(const char* path)
+	: fd_(-1), failed_(0), ring_(0), head_(0), tail_(0),
+	  flushing_(false), closing_(false), next_open_(0)
+{
+	fd_ = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd_ < 0)
+		return;
+	write_header();
+	ring_ = new BinaryQueueEvent[RING_SIZE];
+	writer_ = std::thread(&BinaryQueueTrace::writer, this);
+
+	if (open_ == 0)
+		atexit(close_all);
+	next_open_ = open_;
+	open_ = this;
+}
+
+BinaryQueueTrace::~BinaryQueueTrace()
+{
+	close();
+}
+
+void BinaryQueueTrace::close_all()
+{
+	while (open_ != 0)
+		open_->close();
+}
+
+void BinaryQueueTrace::write_header()
+{
+	int ntypes = PT_NTYPE + 1;
+	size_t names = 0;
+	for (int i = 0; i < ntypes; i++) {
+		const char* name = packet_info.name(i);
+		names += (name != 0 ? strlen(name) : 0) + 1;
+	}
+
+	BinaryQueueTraceHeader h;
+	memset(&h, 0, sizeof(h));
+	strncpy(h.magic, BINARY_QUEUE_TRACE_MAGIC, sizeof(h.magic));
+	h.version = BINARY_QUEUE_TRACE_VERSION;
+	h.record_size = sizeof(BinaryQueueEvent);
+	h.data_offset = (sizeof(h) + names + 63) & ~63;
+	h.ntypes = ntypes;
+
+	char* buf = new char[h.data_offset];
+	memset(buf, 0, h.data_offset);
+	memcpy(buf, &h, sizeof(h));
+	char* q = buf + sizeof(h);
+	for (int i = 0; i < ntypes; i++) {
+		const char* name = packet_info.name(i);
+		if (name != 0) {
+			strcpy(q, name);
+			q += strlen(name);
+		}
+		q++;
+	}
+	failed_ = write_all(fd_, buf, h.data_offset);
+	delete [] buf;
+}
+
+void BinaryQueueTrace::close()
+{
+	if (fd_ < 0)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		closing_ = true;
+	}
+	wake_.notify_one();
+	writer_.join();
+	::close(fd_);
+	fd_ = -1;
+	delete [] ring_;
+	ring_ = 0;
+	if (failed_ != 0)
+		fprintf(stderr, "BinaryQueueTrace: write failed: %s\n",
+			strerror(failed_));
+
+	BinaryQueueTrace** pp = &open_;
+	while (*pp != this)
+		pp = &(*pp)->next_open_;
+	*pp = next_open_;
+}
+
+/* Wait until every record put so far has been written. */
+void BinaryQueueTrace::flush()
+{
+	if (fd_ < 0)
+		return;
+
+	uint64_t head = head_.load(std::memory_order_relaxed);
+	std::unique_lock<std::mutex> lock(mutex_);
+	flushing_ = true;
+	wake_.notify_one();
+	drained_.wait(lock, [&] { return tail_.load() == head; });
+}
+
+void BinaryQueueTrace::wait_for_space()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	flushing_ = true;
+	wake_.notify_one();
+	drained_.wait(lock, [&] {
+		return head_.load(std::memory_order_relaxed) - tail_.load() <
+			RING_SIZE;
+	});
+}
+
+void BinaryQueueTrace::put(const BinaryQueueEvent& ev)
+{
+	uint64_t head = head_.load(std::memory_order_relaxed);
+	if (head - tail_.load(std::memory_order_acquire) == RING_SIZE)
+		wait_for_space();
+	ring_[head & (RING_SIZE - 1)] = ev;
+	head_.store(head + 1, std::memory_order_release);
+
+	/*
+	 * The writer checks for a full batch with mutex_ held, so taking it
+	 * here, once per batch, is enough not to lose the wakeup.
+	 */
+	if (((head + 1) & (BATCH - 1)) == 0) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		wake_.notify_one();
+	}
+}
+
+void BinaryQueueTrace::writer()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	for (;;) {
+		wake_.wait(lock, [this] {
+			return closing_ || flushing_ ||
+				head_.load() - tail_.load() >= BATCH;
+		});
+		bool closing = closing_;
+		flushing_ = false;
+		lock.unlock();
+		write_out();
+		lock.lock();
+		drained_.notify_all();
+		if (closing)
+			return;
+	}
+}
+
+/* Write out everything between tail_ and head_, at most two write(2)s. */
+void BinaryQueueTrace::write_out()
+{
+	uint64_t head = head_.load(std::memory_order_acquire);
+	uint64_t tail = tail_.load(std::memory_order_relaxed);
+	while (tail != head) {
+		uint64_t i = tail & (RING_SIZE - 1);
+		uint64_t n = head - tail;
+		if (n > RING_SIZE - i)
+			n = RING_SIZE - i;
+		if (failed_ == 0)
+			failed_ = write_all(fd_, (const char*)(ring_ + i),
+					    n * sizeof(BinaryQueueEvent));
+		tail += n;
+		tail_.store(tail, std::memory_order_release);
+	}
+}
+
+/*
+ * $trace flush
+ * $trace close
+ */
+int BinaryQueueTrace::command(int argc, const char*const* argv)
+{
+	if (argc == 2) {
+		if (strcmp(argv[1], "flush") == 0) {
+			flush();
+			return (TCL_OK);
+		}
+		if (strcmp(argv[1], "close") == 0) {
+			close();
+			return (TCL_OK);
+		}
+	}
+	return (TclObject::command(argc, argv));
+}
+
+void BinaryQueueTrace::record(int type, int from, int to, int seqno, Packet* p)
+{
+	if (fd_ < 0)
+		return;
+
+	hdr_cmn* th = hdr_cmn::access(p);
+	hdr_ip* iph = hdr_ip::access(p);
+	hdr_flags* hf = hdr_flags::access(p);
+	double now = Scheduler::instance().clock();
+
+	BinaryQueueEvent ev;
+	memset(&ev, 0, sizeof(ev));
+	switch (type) {
+	case '+':
+		ev.event = BinaryQueueEvent::ENQUEUE;
+		break;
+	case '-':
+		ev.event = BinaryQueueEvent::DEQUEUE;
+		break;
+	case 'd':
+		ev.event = BinaryQueueEvent::DROP;
+		break;
+	default:
+		return;
+	}
+
+	ev.size = th->size();
+	ev.src = Address::instance().get_nodeaddr(iph->saddr());
+	ev.dst = Address::instance().get_nodeaddr(iph->daddr());
+	ev.ts = now;
+	ev.id = th->uid();
+	ev.flow_id = iph->flowid();
+
+	if (ev.event == BinaryQueueEvent::ENQUEUE) {
+		arrivals_[th->uid()] = now;
+		ev.delay = std::numeric_limits<double>::infinity();
+	} else {
+		std::unordered_map<int, double>::iterator it =
+			arrivals_.find(th->uid());
+		if (it != arrivals_.end()) {
+			ev.delay = now - it->second;
+			arrivals_.erase(it);
+		} else {
+			ev.delay = std::numeric_limits<double>::infinity();
+		}
+	}
+
+	// same bits as the flags field of Trace::format()
+	ev.from_node = from;
+	ev.to_node = to;
+	ev.ptype = th->ptype();
+	ev.flags = (hf->ecn_ ? 0x01 : 0) | (hf->pri_ ? 0x02 : 0) |
+		(hf->cong_action_ ? 0x08 : 0) | (hf->ecn_to_echo_ ? 0x10 : 0) |
+		(hf->fs_ ? 0x20 : 0) | (hf->ecn_capable_ ? 0x40 : 0);
+	ev.sport = iph->sport();
+	ev.dport = iph->dport();
+	ev.seqno = seqno;
+
+	put(ev);
+}
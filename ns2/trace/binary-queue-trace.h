@@ -0,0 +1,70 @@
+/* -*-	Mode:C++; c-basic-offset:8; tab-width:8; indent-tabs-mode:t -*- */
+/*
+ * Binary queue trace: enqueue, dequeue and drop events written as
+ * fixed-size records (see binary-queue-record.h), so that analysis
+ * tools can map the file directly instead of parsing the text trace.
+ *
+ * Records go into a single-producer ring buffer and a writer thread
+ * drains it with large write(2) calls, so the simulation thread never
+ * formats or writes anything itself.
+ */
+
+#ifndef ns_binary_queue_trace_h
+#define ns_binary_queue_trace_h
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "packet.h"
+#include "binary-queue-record.h"
+
+class BinaryQueueTrace : public TclObject {
+public:
+	BinaryQueueTrace(const char* path);
+	~BinaryQueueTrace();
+
+	int command(int argc, const char*const* argv);
+	void record(int type, int from, int to, int seqno, Packet* p);
+	void flush();
+	void close();
+
+	inline bool is_open() const { return fd_ >= 0; }
+	inline static bool any_open() { return open_ != 0; }
+
+protected:
+	enum {
+		RING_SIZE = 1 << 16,		// records, a power of two
+		BATCH = RING_SIZE / 8		// records per wakeup of the writer
+	};
+
+	void write_header();
+	void put(const BinaryQueueEvent& ev);
+	void wait_for_space();
+	void writer();
+	void write_out();
+	static void close_all();
+
+	int fd_;
+	int failed_;		// errno of the first failed write
+	BinaryQueueEvent* ring_;
+	std::atomic<uint64_t> head_;	// next record to put, simulation thread
+	std::atomic<uint64_t> tail_;	// next record to write, writer thread
+
+	std::thread writer_;
+	std::mutex mutex_;
+	std::condition_variable wake_;		// writer has work
+	std::condition_variable drained_;	// writer advanced tail_
+	bool flushing_;
+	bool closing_;
+
+	std::unordered_map<int, double> arrivals_;
+
+	// open traces, closed at exit so that no records are lost
+	BinaryQueueTrace* next_open_;
+	static BinaryQueueTrace* open_;
+};
+
+#endif
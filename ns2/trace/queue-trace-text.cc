@@ -0,0 +1,111 @@
+/* -*-	Mode:C++; c-basic-offset:8; tab-width:8; indent-tabs-mode:t -*- */
+/*
+ * queue-trace-text: print a binary queue trace in the text format of
+ * Trace::format(), as "$ns trace-queue" would have written it.
+ *
+ * usage: queue-trace-text file.bin [file.tr]
+ *
+ * Node addresses are printed flat and the tagged, show_tcphdr_ and SCTP
+ * variants of the format are not reproduced.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "binary-queue-record.h"
+
+#define CHUNK 4096	// records read at a time
+
+static double
+round_time(double x)
+{
+	// as BaseTrace::round()
+	return floor(x * 1.0E+6 + 0.5) / 1.0E+6;
+}
+
+int
+main(int argc, char** argv)
+{
+	if (argc < 2 || argc > 3) {
+		fprintf(stderr, "usage: %s file.bin [file.tr]\n", argv[0]);
+		return 1;
+	}
+	FILE* in = fopen(argv[1], "rb");
+	if (in == 0) {
+		perror(argv[1]);
+		return 1;
+	}
+	FILE* out = stdout;
+	if (argc == 3 && (out = fopen(argv[2], "w")) == 0) {
+		perror(argv[2]);
+		return 1;
+	}
+
+	BinaryQueueTraceHeader h;
+	if (fread(&h, sizeof(h), 1, in) != 1 ||
+	    strncmp(h.magic, BINARY_QUEUE_TRACE_MAGIC, sizeof(h.magic)) != 0 ||
+	    h.version != BINARY_QUEUE_TRACE_VERSION ||
+	    h.record_size != sizeof(BinaryQueueEvent) ||
+	    h.data_offset < sizeof(h)) {
+		fprintf(stderr, "%s: not a version %d binary queue trace\n",
+			argv[1], BINARY_QUEUE_TRACE_VERSION);
+		return 1;
+	}
+
+	size_t names_len = h.data_offset - sizeof(h);
+	char* names = new char[names_len + 1];
+	if (fread(names, 1, names_len, in) != names_len) {
+		fprintf(stderr, "%s: truncated header\n", argv[1]);
+		return 1;
+	}
+	names[names_len] = 0;
+	const char** ptypes = new const char*[h.ntypes];
+	char* q = names;
+	for (uint32_t i = 0; i < h.ntypes; i++) {
+		ptypes[i] = q;
+		q += strlen(q) + 1;
+		if (q > names + names_len)
+			q = names + names_len;
+	}
+
+	static const char events[] = { 0, '+', '-', 'd' };
+	const char* flagchars = BINARY_QUEUE_TRACE_FLAGS;
+	int nflags = strlen(flagchars);
+	BinaryQueueEvent* buf = new BinaryQueueEvent[CHUNK];
+	size_t n;
+	while ((n = fread(buf, sizeof(BinaryQueueEvent), CHUNK, in)) > 0) {
+		for (size_t i = 0; i < n; i++) {
+			const BinaryQueueEvent& ev = buf[i];
+			if (ev.event < 1 || ev.event > 3)
+				continue;
+			char flags[16];
+			for (int f = 0; f < nflags; f++)
+				flags[f] = (ev.flags & (1 << f)) ? flagchars[f] : '-';
+			flags[nflags] = 0;
+			char ptype[16];
+			const char* name = ptype;
+			if (ev.ptype < h.ntypes && ptypes[ev.ptype][0] != 0)
+				name = ptypes[ev.ptype];
+			else
+				sprintf(ptype, "%u", ev.ptype);
+
+			fprintf(out, "%c %.15g %u %u %s %u %s %lld %u.%d %u.%d %d %lld\n",
+				events[ev.event], round_time(ev.ts),
+				ev.from_node, ev.to_node, name, ev.size, flags,
+				(long long)ev.flow_id,
+				ev.src, ev.sport, ev.dst, ev.dport, ev.seqno,
+				(long long)ev.id);
+		}
+	}
+	if (ferror(in)) {
+		perror(argv[1]);
+		return 1;
+	}
+	if (fclose(out) != 0) {
+		perror(argc == 3 ? argv[2] : "stdout");
+		return 1;
+	}
+	return 0;
+}
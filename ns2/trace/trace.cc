@@ -63,7 +63,7 @@ public:
 
 
 Trace::Trace(int type)
-	: Connector(), callback_(0), pt_(0), type_(type)
+	: Connector(), callback_(0), pt_(0), bt_(0), type_(type)
 {
 	bind("src_", (int*)&src_);
 	bind("dst_", (int*)&dst_);
@@ -81,6 +81,7 @@ Trace::~Trace()
  * $trace detach
  * $trace flush
  * $trace attach $fileID
+ * $trace binary-attach $binaryQueueTrace
  */
 int Trace::command(int argc, const char*const* argv)
 {
@@ -100,6 +101,8 @@ int Trace::command(int argc, const char*const* argv)
 			if (namch != 0)
 				//Tcl_Flush(pt_->namchannel());
 				pt_->flush(namch);
+			if (bt_ != 0)
+				bt_->flush();
 			return (TCL_OK);
 		}
                 if (strcmp(argv[1], "tagged") == 0) {
@@ -124,6 +127,14 @@ int Trace::command(int argc, const char*const* argv)
 			}
 			return (TCL_OK);
 		}
+		if (strcmp(argv[1], "binary-attach") == 0) {
+			bt_ = (BinaryQueueTrace*)TclObject::lookup(argv[2]);
+			if (bt_ == 0) {
+				tcl.resultf("trace: no binary trace %s", argv[2]);
+				return (TCL_ERROR);
+			}
+			return (TCL_OK);
+		}
 		if (strcmp(argv[1], "namattach") == 0) {
 			int mode;
 			const char* id = argv[2];
@@ -424,12 +435,26 @@ void Trace::format(int tt, int s, int d, Packet* p)
    	delete [] dst_portaddr;
 }
 
+/*
+ * With only a binary trace attached there is nobody to read the text
+ * record, so skip formatting it.
+ */
+int Trace::text_enabled()
+{
+	return (bt_ == 0 || pt_->channel() != 0 || pt_->namchannel() != 0 ||
+		callback_);
+}
+
 void Trace::recv(Packet* p, Handler* h)
 {
-	format(type_, src_, dst_, p);
-	pt_->dump();
-	callback();
-	pt_->namdump();
+	if (bt_ != 0)
+		bt_->record(type_, src_, dst_, get_seqno(p), p);
+	if (text_enabled()) {
+		format(type_, src_, dst_, p);
+		pt_->dump();
+		callback();
+		pt_->namdump();
+	}
 	/* hack: if trace object not attached to anything free packet */
 	if (target_ == 0)
 		Packet::free(p);
@@ -504,6 +529,11 @@ DequeTrace::~DequeTrace()
 void 
 DequeTrace::recv(Packet* p, Handler* h)
 {
+	if (bt_ != 0)
+		bt_->record(type_, src_, dst_, get_seqno(p), p);
+	if (!text_enabled())
+		goto done;
+
 	// write the '-' event first
 	format(type_, src_, dst_, p);
 	pt_->dump();
@@ -598,6 +628,7 @@ DequeTrace::recv(Packet* p, Handler* h)
 		delete [] dst_portaddr;
 	}
 
+done:
 	/* hack: if trace object not attached to anything free packet */
 	if (target_ == 0)
 		Packet::free(p);
@@ -42,6 +42,7 @@
 #include <math.h> // floor
 #include "packet.h"
 #include "basetrace.h"
+#include "binary-queue-trace.h"
 
 
 /* Tracing has evolved into two types, packet tracing and event tracing.
@@ -63,11 +64,13 @@ protected:
 	int show_tcphdr_;  // bool flags; backward compat
 	int show_sctphdr_; // bool flags; backward compat
 	void callback();
+	int text_enabled();
 public:
 	Trace(int type);
         ~Trace();
 
 	BaseTrace *pt_;    // support for pkt tracing
+	BinaryQueueTrace *bt_;	// optional binary queue trace
 
 	int type_;	
         int command(int argc, const char*const* argv);
@@ -2,6 +2,7 @@ import os
 import sys
 from collections import namedtuple
 import subprocess
+from tempfile import NamedTemporaryFile, TemporaryFile
 from enum import Enum, auto
 from itertools import chain, islice, dropwhile, takewhile
 import json
@@ -483,15 +484,16 @@ class LocalGreedyLearningAlgorithm(LearningAlgorithm, name='local_greedy'):
 
 
 class LearningParams(namedtuple('LearningParams',
-                                ['start_time', 'algo', 'reward', 'interval_selector'])):
+                                ['start_time', 'algo', 'reward', 'interval_selector',
+                                 'shadows'])):
     __slots__ = ()
 
     def __new__(cls, start_time=0, algo=UCBLearningAlgorithm(),
                 reward=ThroughputReward(), 
                 interval_selector=FixedIntervalSelector(),
-                num_submeasurements=0):
+                num_submeasurements=0, shadows=False):
         return super(LearningParams, cls).__new__(
-            cls, start_time, algo, reward, interval_selector)
+            cls, start_time, algo, reward, interval_selector, shadows)
 
     @property
     def algo_json(self):
@@ -502,7 +504,8 @@ class LearningParams(namedtuple('LearningParams',
         return (_optional(self.start_time > 0, f'lst{self.start_time}')
                 + self.algo.short_rep
                 + self.interval_selector.short_rep
-                + self.reward.short_rep)
+                + self.reward.short_rep
+                + _optional(self.shadows, 'sh'))
 
 
 class NodeType(Enum):
@@ -557,7 +560,7 @@ class NS2(namedtuple('NS2', ['ftp', 'web', 'cbr', 'learning', 'bottleneck', 'del
                                        bottleneck, delay, algorithms,
                                        duration)
 
-    def run(self, seed, trace_dir, trace_nam, show_std):
+    def _args(self, seed, trace_dir, trace_nam):
         common_args = [str(self.duration), trace_dir,
                        self._flag(trace_nam), str(seed)]
         ftp_args = [str(self.ftp.num), str(self.ftp.start_time),
@@ -572,31 +575,68 @@ class NS2(namedtuple('NS2', ['ftp', 'web', 'cbr', 'learning', 'bottleneck', 'del
                       (self.delay.access, self.delay.bottleneck)]
         algorithms = [x.command(self) for x in self.algorithms]
 
-        # TODO: this should be cleaner, perhaps...
-        algo_json_fname = os.path.join(trace_dir, "algo.json")
-        with open(algo_json_fname, 'w') as f:
-            json.dump(self.learning.algo_json, f)
-
         learning_args = [str(self.learning.start_time), 
-                         str(algo_json_fname),
+                         str(self._write_algo_json(trace_dir)),
                          str(self.learning.interval_selector.command()),
-                         str(self.learning.reward.command(self))]
+                         str(self.learning.reward.command(self)),
+                         self._flag(self.learning.shadows)]
 
-        args = list(chain(common_args, ftp_args, web_args, cbr_args, link_args, delay_args,
+        return list(chain(common_args, ftp_args, web_args, cbr_args, link_args, delay_args,
                           learning_args, algorithms))
 
-        out = None if show_std else subprocess.PIPE
-        ns2_result = subprocess.run([self.NS_PATH, 'codel.tcl'] + args,
-                                    stderr=out, stdout=out)
-
-        if ns2_result.returncode != 0:
-            print('the NS2 simulator has failed:', file=sys.stderr)
-            print('args: ', *(f'"{arg}"' for arg in args), file=sys.stderr)
-            if not show_std:
-                print('====== STDIN ======', ns2_result.stdout.decode('ascii'),
-                      '====== STDERR =====', ns2_result.stderr.decode('ascii'),
-                      sep='\n', file=sys.stderr)
-            raise RuntimeError('NS2 has failed')
+    def _write_algo_json(self, trace_dir):
+        # TODO: this should be cleaner, perhaps...
+        algo_json_fname = os.path.join(trace_dir, "algo.json")
+        with open(algo_json_fname, 'w') as f:
+            json.dump(self.learning.algo_json, f)
+        return algo_json_fname
+
+    def _ns(self, ns_args, args, show_std, on_exit=None):
+        """Runs ns on codel.tcl.  With on_exit, ns writes a -batch-log and
+        on_exit(run, status) is called as each of the batch's runs exits."""
+        with TemporaryFile() as stdout, TemporaryFile() as stderr:
+            out = {} if show_std else {'stdout': stdout, 'stderr': stderr}
+            log_fds = os.pipe() if on_exit is not None else None
+            if log_fds is not None:
+                ns_args = ns_args + ['-batch-log', f'/dev/fd/{log_fds[1]}']
+            proc = subprocess.Popen(
+                [self.NS_PATH] + ns_args + ['codel.tcl'] + args,
+                pass_fds=log_fds[1:] if log_fds is not None else (), **out)
+            if log_fds is not None:
+                os.close(log_fds[1])
+                with os.fdopen(log_fds[0]) as log:
+                    for line in log:
+                        run, status = map(int, line.split())
+                        on_exit(run, status)
+
+            if proc.wait() != 0:
+                print('the NS2 simulator has failed:', file=sys.stderr)
+                print('args: ', *(f'"{arg}"' for arg in args), file=sys.stderr)
+                if not show_std:
+                    stdout.seek(0)
+                    stderr.seek(0)
+                    print('====== STDIN ======', stdout.read().decode('ascii'),
+                          '====== STDERR =====', stderr.read().decode('ascii'),
+                          sep='\n', file=sys.stderr)
+                raise RuntimeError('NS2 has failed')
+
+    def run(self, seed, trace_dir, trace_nam, show_std):
+        self._ns([], self._args(seed, trace_dir, trace_nam), show_std)
+
+    def run_batch(self, runs, trace_nam, show_std, jobs=None, on_exit=None):
+        """Runs (seed, trace_dir) pairs in one ns process, which builds
+        the scenario once and forks a run from codel.tcl's checkpoint.
+        on_exit(i, status) is called, from this thread, as runs[i] exits."""
+        seed, trace_dir = runs[0]
+        args = self._args(seed, trace_dir, trace_nam)
+        with NamedTemporaryFile('w', suffix='.runs') as spec:
+            for seed, trace_dir in runs:
+                spec.write(f'{seed} seed {seed} trace_dir {{{trace_dir}}}'
+                           f' learning_algo {{{self._write_algo_json(trace_dir)}}}\n')
+            spec.flush()
+            ns_args = (['-batch', spec.name]
+                       + _optional(jobs is not None, '-jobs', str(jobs)))
+            self._ns(ns_args, args, show_std, on_exit)
 
     @property
     def short_rep(self):
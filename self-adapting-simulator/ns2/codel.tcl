@@ -52,6 +52,7 @@ set reward_command {
 
 set arg 0
 set learning_start_time 0
+set shadow_policies 0
 
 if {$argc >= [expr $arg+1]} {
     set stopTime [lindex $argv $arg]
@@ -148,6 +149,11 @@ if {$argc >= [expr $arg+1]} {
     incr arg 1
 }
 
+if {$argc >= [expr $arg+1]} {
+    set shadow_policies [lindex $argv $arg]
+    incr arg 1
+}
+
 # CoDel values
 for {} {$arg < $argc} {incr arg 1} { 
     lappend queue_management_algos [lindex $argv $arg]
@@ -168,6 +174,11 @@ set realrtt [expr 2*(2*$accessdly + $bdelay)]
 #
 # puts "accessdly $accessdly bneckdly $bdelay realrtt $realrtt bneckbw $bw"
 
+# With "ns -batch", runs fork from here and override seed, trace_dir and
+# learning_algo.  The topology below opens per-run traces and draws from
+# the RNG, so it has to stay after the checkpoint.
+ns-checkpoint
+
 global defaultRNG
 if {$seed != 0} {
     $defaultRNG seed $seed
@@ -276,15 +287,23 @@ set buffersize1 [expr $bdp*10]
 proc setup_forward_link { link } {
     global ns learning_algo target interval interval_selector_command
     global learning_start_time 
-    global bw reward_command trace_dir queue_management_algos
+    global bw reward_command trace_dir queue_management_algos shadow_policies
 
     set codel_drop_trace [open $trace_dir/codel_drop.tr w]
     set codel_trace [open $trace_dir/codel.tr w]
     for {set k 0} {$k < [llength $queue_management_algos]} {incr k 1} { 
         set codel [eval [lindex $queue_management_algos $k]]
-        $link add_policy $codel
+        if {$shadow_policies > 0} {
+            # shadows must not write into the real policy traces
+            set real_codel_trace $codel_trace
+            set codel_trace [open /dev/null w]
+            set shadow [eval [lindex $queue_management_algos $k]]
+            set codel_trace $real_codel_trace
+            $link add_policy $codel $shadow
+        } else {
+            $link add_policy $codel
+        }
     }
-
     $link set_learning $learning_algo
     $link set_interval_selector [eval $interval_selector_command]
     $link set_reward [eval $reward_command]
@@ -577,7 +596,7 @@ if { $trace_dir != "none"} {
     $qm set-delay-samples $delay
 
     # queue tracing
-    $ns trace-queue $n0 $n1 [open $trace_dir/queue.tr w]
+    $ns trace-queue-binary $n0 $n1 $trace_dir/queue.bin
 }
 
 #reverse direction
@@ -28,24 +28,22 @@ PERSISTENCE = tracing.SequencePersistence(
 TracingConfig = namedtuple('TracingConfig', ['nam', 'trace'])
 
 
-def run_codel_process(ns2: codel.NS2, seed, config: TracingConfig, show_std=False):
-    with TemporaryDirectory() as temp_dir:
-        ns2.run(seed, temp_dir, config.nam, show_std)
+def save_traces(ns2: codel.NS2, seed, temp_dir, config: TracingConfig,
+                show_std=False):
+    queue_trace = tracing.QueueTrace.parse(ns2, temp_dir)
 
-        queue_trace = tracing.QueueTrace.parse(ns2, temp_dir)
+    for trace in config.trace:
+        if trace is tracing.QueueTrace:
+            trace_result = queue_trace
+        elif trace is tracing.StatsTrace:
+            trace_result = trace.generate_stats(temp_dir, ns2, seed, queue_trace)
+        else:
+            trace_result = trace.parse(ns2, temp_dir)
 
-        for trace in config.trace:
-            if trace is tracing.QueueTrace:
-                trace_result = queue_trace
-            elif trace is tracing.StatsTrace:
-                trace_result = trace.generate_stats(temp_dir, ns2, seed, queue_trace)
-            else:
-                trace_result = trace.parse(ns2, temp_dir)
+        trace.save(ns2, seed, PERSISTENCE, trace_result)
 
-            trace.save(ns2, seed, PERSISTENCE, trace_result)
-
-        if tracing.StatsTrace in config.trace and show_std:
-            tracing.helpers.do_print_basic_stats(queue_trace)
+    if tracing.StatsTrace in config.trace and show_std:
+        tracing.helpers.do_print_basic_stats(queue_trace)
 
 
 def generate_codel_variants(intervals, targets):
@@ -53,10 +51,11 @@ def generate_codel_variants(intervals, targets):
                  for int, tar in product(intervals, targets))
 
 
-async def run_codel(ns2, config, seed):
+async def save_run(ns2, config, seed, temp_dir):
     await asyncio.get_event_loop().run_in_executor(
-        EXECUTOR, run_codel_process, ns2, seed, config, TOTAL == 1
+        EXECUTOR, save_traces, ns2, seed, temp_dir.name, config, TOTAL == 1
     )
+    temp_dir.cleanup()
 
     global COUNTER
     COUNTER += 1
@@ -67,6 +66,30 @@ async def run_codel(ns2, config, seed):
             print()
 
 
+async def run_codel(ns2, config, seeds, jobs):
+    # a single ns process builds the scenario and forks a run per seed;
+    # each run's traces are parsed as soon as it exits, while the others
+    # are still simulating
+    loop = asyncio.get_event_loop()
+    temp_dirs = [TemporaryDirectory() for _ in seeds]
+    saving = []
+
+    def run_exited(run, status):
+        if status == 0:
+            saving.append(asyncio.ensure_future(
+                save_run(ns2, config, seeds[run], temp_dirs[run])))
+
+    try:
+        await loop.run_in_executor(
+            None, ns2.run_batch, [(seed, d.name) for seed, d in zip(seeds, temp_dirs)],
+            config.nam, TOTAL == 1, jobs,
+            lambda run, status: loop.call_soon_threadsafe(run_exited, run, status))
+    finally:
+        await asyncio.gather(*saving)
+        for temp_dir in temp_dirs:
+            temp_dir.cleanup()
+
+
 @click.command()
 @click.option('--duration', default=300, type=int,
               help='Run duration (in seconds)')
@@ -215,12 +238,11 @@ def run(num_runs, start_run, num_ftps, ftp_start_time, web_rate, web_start_time,
     if trace_dir is not None:
         PERSISTENCE = tracing.TraceDirPersistence(trace_dir)
 
+    seeds = [seed or (run_id + 1)
+             for run_id in range(start_run, start_run + num_runs)]
     loop = asyncio.get_event_loop()
     try:
-        loop.run_until_complete(asyncio.gather(*(
-            run_codel(ns2, config, seed or (run_id + 1))
-            for run_id in range(start_run, start_run + num_runs)
-        )))
+        loop.run_until_complete(run_codel(ns2, config, seeds, num_threads))
     finally:
         EXECUTOR.shutdown()
 
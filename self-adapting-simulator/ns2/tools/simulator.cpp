@@ -0,0 +1,159 @@
+#include <boost/python.hpp>
+#include <boost/python/numpy.hpp>
+
+#include <schad/configs/experiment_config.h>
+#include <schad/simulator/simulation.h>
+#include <schad/simulator/stats_sink.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+namespace py = boost::python;
+namespace np = py::numpy;
+
+auto to_json(py::object const& obj) -> schad::json {
+    if (obj.is_none()) {
+        return nullptr;
+    }
+    if (PyBool_Check(obj.ptr())) {
+        return py::extract<bool>(obj)();
+    }
+    if (PyLong_Check(obj.ptr())) {
+        return py::extract<int64_t>(obj)();
+    }
+    if (PyFloat_Check(obj.ptr())) {
+        return py::extract<double>(obj)();
+    }
+    if (PyUnicode_Check(obj.ptr())) {
+        return py::extract<std::string>(obj)();
+    }
+    if (PyDict_Check(obj.ptr())) {
+        auto result = schad::json::object();
+        py::list const items = py::dict(obj).items();
+        for (auto i = 0; i < py::len(items); ++i) {
+            std::string const key = py::extract<std::string>(items[i][0]);
+            result[key] = to_json(items[i][1]);
+        }
+        return result;
+    }
+    if (PyList_Check(obj.ptr()) || PyTuple_Check(obj.ptr())) {
+        auto result = schad::json::array();
+        for (auto i = 0; i < py::len(obj); ++i) {
+            result.push_back(to_json(obj[i]));
+        }
+        return result;
+    }
+    throw std::invalid_argument(
+        "Unsupported configuration value of type " +
+        std::string(Py_TYPE(obj.ptr())->tp_name)
+    );
+}
+
+class ColumnStatsSink : public schad::StatsSink {
+public:
+    explicit ColumnStatsSink(size_t num_arms)
+        : StatsSink{num_arms}, num_arms_{num_arms}, num_runs_{0},
+          num_batches_{0}, rewards_{}, totals_{}, arms_{} {
+    }
+
+    auto rewards() const -> np::ndarray {
+        return to_array(rewards_, {num_runs_, num_batches_});
+    }
+
+    auto totals() const -> np::ndarray {
+        return to_array(totals_, {num_runs_, num_batches_});
+    }
+
+    auto arms() const -> np::ndarray {
+        return to_array(arms_, {num_runs_, num_arms_, num_batches_});
+    }
+
+protected:
+    void write(schad::RunStatistics run) override {
+        if (num_runs_ == 0) {
+            num_batches_ = run.rewards.size();
+        } else if (run.rewards.size() != num_batches_) {
+            throw std::runtime_error("Runs differ in number of batches");
+        }
+
+        rewards_.insert(end(rewards_), begin(run.rewards), end(run.rewards));
+        totals_.insert(end(totals_), begin(run.totals), end(run.totals));
+        for (auto const& arm : run.arms) {
+            arms_.insert(end(arms_), begin(arm), end(arm));
+        }
+        num_runs_++;
+    }
+
+private:
+    template<class T>
+    static auto to_array(std::vector<T> const& values,
+            std::vector<size_t> const& shape) -> np::ndarray {
+        py::list dims{};
+        for (auto d : shape) {
+            dims.append(d);
+        }
+        auto result = np::empty(py::tuple(dims), np::dtype::get_builtin<T>());
+        std::memcpy(result.get_data(), values.data(), values.size() * sizeof(T));
+        return result;
+    }
+
+private:
+    size_t const num_arms_;
+    size_t num_runs_;
+    size_t num_batches_;
+    std::vector<double> rewards_;
+    std::vector<double> totals_;
+    std::vector<uint64_t> arms_;
+};
+
+class ReleaseGIL {
+public:
+    ReleaseGIL() : state_{PyEval_SaveThread()} {
+    }
+
+    ~ReleaseGIL() {
+        PyEval_RestoreThread(state_);
+    }
+
+    ReleaseGIL(ReleaseGIL const&) = delete;
+    ReleaseGIL& operator=(ReleaseGIL const&) = delete;
+
+private:
+    PyThreadState * const state_;
+};
+
+py::dict run(py::object const& config, size_t num_threads,
+        std::string const& working_dir) {
+    auto const experiment = working_dir.empty()
+        ? schad::Loader::load_from_dir(schad::load_experiment, to_json(config))
+        : schad::Loader::load_from_dir(
+            schad::load_experiment, to_json(config), working_dir
+        );
+
+    ColumnStatsSink sink{experiment.policies().size()};
+    {
+        ReleaseGIL no_gil{};
+        schad::run(experiment, sink, num_threads);
+    }
+
+    py::dict result{};
+    result["rewards"] = sink.rewards();
+    result["totals"] = sink.totals();
+    result["arms"] = sink.arms();
+    return result;
+}
+
+}
+
+BOOST_PYTHON_MODULE(libsimulator)
+{
+    using namespace boost::python;
+
+    numpy::initialize();
+    def("run", &run, (
+        arg("config"), arg("num_threads") = 0, arg("working_dir") = ""
+    ));
+}
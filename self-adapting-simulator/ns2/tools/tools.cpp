@@ -1,12 +1,28 @@
 #include <boost/python.hpp>
 #include <boost/python/numpy.hpp>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <future>
 #include <iostream>
+#include <iterator>
 #include <limits>
+#include <memory>
 #include <fstream>
 #include <vector>
 #include <map>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 
 namespace {
 
@@ -22,6 +38,314 @@ struct QueueEvent {
     uint64_t id;
     uint64_t flow_id;
     double delay;
+    uint16_t from_node;
+    uint16_t to_node;
+    uint16_t ptype;
+    uint16_t flags;
+    int32_t sport;
+    int32_t dport;
+    int32_t seqno;
+};
+
+struct QueueTraceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t data_offset;
+    uint32_t ntypes;
+};
+
+constexpr char QUEUE_TRACE_MAGIC[8] = "NSQUEUE";
+constexpr uint32_t QUEUE_TRACE_VERSION = 2;
+
+class MappedFile {
+public:
+    explicit MappedFile(std::string const& path) : data_{nullptr}, size_{0} {
+        auto const fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Unable to open " + path);
+        }
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Unable to stat " + path);
+        }
+        size_ = st.st_size;
+
+        if (size_ > 0) {
+            data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (data_ == MAP_FAILED) {
+            throw std::runtime_error("Unable to mmap " + path);
+        }
+    }
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            ::munmap(data_, size_);
+        }
+    }
+
+    auto data() const -> char const * {
+        return static_cast<char const *>(data_);
+    }
+
+    auto size() const {
+        return size_;
+    }
+
+private:
+    void * data_;
+    size_t size_;
+};
+
+using Chunk = std::pair<char const *, char const *>;
+
+auto split_lines(char const * begin, char const * end) -> std::vector<Chunk> {
+    constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+
+    auto const size = size_t(end - begin);
+    auto const num_chunks = std::max<size_t>(1, std::min<size_t>(
+        std::thread::hardware_concurrency(), size / MIN_CHUNK_SIZE
+    ));
+
+    std::vector<Chunk> chunks{};
+    auto chunk_begin = begin;
+    for (auto i = 1u; i <= num_chunks; ++i) {
+        auto chunk_end = i == num_chunks ? end : begin + size / num_chunks * i;
+        chunk_end = std::max(chunk_end, chunk_begin);
+        chunk_end = std::find(chunk_end, end, '\n');
+        if (chunk_end != end) {
+            ++chunk_end;
+        }
+        chunks.emplace_back(chunk_begin, chunk_end);
+        chunk_begin = chunk_end;
+    }
+    return chunks;
+}
+
+template<class ParseChunk>
+auto parse_chunks(MappedFile const& file, ParseChunk parse) 
+        -> std::vector<decltype(parse(Chunk{}))> {
+    auto const chunks = split_lines(file.data(), file.data() + file.size());
+
+    std::vector<std::future<decltype(parse(Chunk{}))>> futures{};
+    for (auto const& chunk : chunks) {
+        futures.push_back(std::async(std::launch::async, parse, chunk));
+    }
+
+    std::vector<decltype(parse(Chunk{}))> results{};
+    for (auto& f : futures) {
+        results.push_back(f.get());
+    }
+    return results;
+}
+
+class LineScanner {
+public:
+    explicit LineScanner(Chunk chunk) : pos_{chunk.first}, end_{chunk.second} {
+    }
+
+    auto at_end() const {
+        return pos_ == end_;
+    }
+
+    auto token() -> std::string_view {
+        while (pos_ != end_ && (*pos_ == ' ' || *pos_ == '\t' || *pos_ == '\r')) {
+            ++pos_;
+        }
+        auto const begin = pos_;
+        while (pos_ != end_ && !std::isspace(static_cast<unsigned char>(*pos_))) {
+            ++pos_;
+        }
+        return std::string_view(begin, pos_ - begin);
+    }
+
+    void next_line() {
+        pos_ = std::find(pos_, end_, '\n');
+        if (pos_ != end_) {
+            ++pos_;
+        }
+    }
+
+private:
+    char const * pos_;
+    char const * end_;
+};
+
+auto to_uint(std::string_view s) -> uint64_t {
+    if (s.empty() || !std::isdigit(static_cast<unsigned char>(s.front()))) {
+        throw std::invalid_argument("Bad integer: " + std::string(s));
+    }
+
+    uint64_t result = 0;
+    for (auto c : s) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) {
+            break;
+        }
+        result = result * 10 + (c - '0');
+    }
+    return result;
+}
+
+auto to_int(std::string_view s) -> int32_t {
+    if (!s.empty() && s.front() == '-') {
+        return -int32_t(to_uint(s.substr(1)));
+    }
+    return int32_t(to_uint(s));
+}
+
+// "addr.port" as Trace::format() prints source and destination.
+auto to_endpoint(std::string_view s) -> std::pair<uint16_t, int32_t> {
+    auto const dot = s.rfind('.');
+    if (dot == std::string_view::npos) {
+        return {uint16_t(to_uint(s)), 0};
+    }
+    return {uint16_t(to_uint(s.substr(0, dot))), to_int(s.substr(dot + 1))};
+}
+
+// The flags field of the text trace, one bit per character that is not
+// '-', as the binary trace stores it.
+auto to_flags(std::string_view s) -> uint16_t {
+    constexpr std::string_view FLAGS = "CP-AEFN";
+
+    uint16_t result = 0;
+    for (auto i = 0u; i < std::min(s.size(), FLAGS.size()); ++i) {
+        if (s[i] != '-') {
+            result |= 1 << i;
+        }
+    }
+    return result;
+}
+
+// Packet type names in the order of ns's packet_t, which numbers the
+// binary trace's ptype.  Types registered at run time are not known here
+// and come out as PT_NTYPE ("undefined"), unless printed as a number.
+auto to_ptype(std::string_view s) -> uint16_t {
+    static constexpr char const * NAMES[] = {
+        "tcp", "udp", "cbr", "audio", "video", "ack", "start", "stop",
+        "prune", "graft", "graftAck", "join", "assert", "message", "rtcp",
+        "rtp", "rtProtoDV", "CtrMcast_Encap", "CtrMcast_Decap", "SRM",
+        "sa_req", "sa_accept", "sa_conf", "sa_teardown", "live", "sa_reject",
+        "telnet", "ftp", "pareto", "exp", "httpInval", "http", "encap",
+        "mftp", "ARP", "MAC", "TORA", "DSR", "AODV", "IMEP", "rap_data",
+        "rap_ack", "tcpFriend", "tcpFriendCtl", "ping", "PBC", "diffusion",
+        "rtProtoLS", "LDP", "gaf", "ra", "pushback", "PGM", "LMS",
+        "LMS_SETUP", "sctp", "sctp_app1", "smac", "xcp", "HDLC",
+        "BellLabsTrace", "AOMDV", "PUMA", "DCCP", "DCCP_Request",
+        "DCCP_Response", "DCCP_Ack", "DCCP_Data", "DCCP_DataAck",
+        "DCCP_Close", "DCCP_CloseReq", "DCCP_Reset", "MDART", "undefined"
+    };
+    static auto const ptypes = [] {
+        std::unordered_map<std::string_view, uint16_t> result{};
+        for (auto i = 0u; i < std::size(NAMES); ++i) {
+            result.emplace(NAMES[i], i);
+        }
+        return result;
+    }();
+
+    if (auto it = ptypes.find(s); it != ptypes.end()) {
+        return it->second;
+    }
+    if (!s.empty() && std::isdigit(static_cast<unsigned char>(s.front()))) {
+        return to_uint(s);
+    }
+    return std::size(NAMES) - 1;
+}
+
+// Exact for up to 15 significant digits and |exponent| <= 22, since both
+// the mantissa and the power of ten are then exactly representable.
+// Everything else goes through strtod.
+auto to_double(std::string_view s) -> double {
+    static constexpr double POW10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    auto p = s.begin();
+    auto const end = s.end();
+    auto const negative = p != end && *p == '-';
+    if (p != end && (*p == '-' || *p == '+')) {
+        ++p;
+    }
+
+    uint64_t mantissa = 0;
+    int num_digits = 0;
+    int significant = 0;
+    int exponent = 0;
+    for (; p != end && std::isdigit(static_cast<unsigned char>(*p)); ++p) {
+        mantissa = mantissa * 10 + (*p - '0');
+        significant += mantissa != 0;
+        num_digits++;
+    }
+    if (p != end && *p == '.') {
+        for (++p; p != end && std::isdigit(static_cast<unsigned char>(*p)); ++p) {
+            mantissa = mantissa * 10 + (*p - '0');
+            significant += mantissa != 0;
+            num_digits++;
+            exponent--;
+        }
+    }
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        auto const exp_negative = p != end && *p == '-';
+        if (p != end && (*p == '-' || *p == '+')) {
+            ++p;
+        }
+        int e = 0;
+        for (; p != end && std::isdigit(static_cast<unsigned char>(*p)) && e < 10000; ++p) {
+            e = e * 10 + (*p - '0');
+        }
+        exponent += exp_negative ? -e : e;
+    }
+
+    if (num_digits == 0 || p != end || significant > 15 || 
+            exponent < -22 || exponent > 22) {
+        auto const str = std::string(s);
+        char * parsed_end = nullptr;
+        auto const result = std::strtod(str.c_str(), &parsed_end);
+        if (parsed_end == str.c_str()) {
+            throw std::invalid_argument("Bad number: " + str);
+        }
+        return result;
+    }
+
+    auto const value = exponent < 0 
+        ? double(mantissa) / POW10[-exponent] 
+        : double(mantissa) * POW10[exponent];
+    return negative ? -value : value;
+}
+
+template<class T>
+auto concatenate(np::dtype const& dtype, std::vector<std::vector<T>> const& parts)
+        -> np::ndarray {
+    if (dtype.get_itemsize() != sizeof(T)) {
+        throw std::logic_error("Wrong dtype size!");
+    }
+
+    size_t total = 0;
+    for (auto const& part : parts) {
+        total += part.size();
+    }
+
+    auto result = np::empty(py::make_tuple(total), dtype);
+    auto out = result.get_data();
+    for (auto const& part : parts) {
+        std::memcpy(out, part.data(), part.size() * sizeof(T));
+        out += part.size() * sizeof(T);
+    }
+    return result;
+}
+
+struct QueueChunk {
+    std::vector<QueueEvent> events;
+    std::vector<size_t> unmatched;
+    std::unordered_map<uint64_t, double> pending_arrivals;
 };
 
 auto parse_queue_trace(std::string trace_path) -> np::ndarray {
@@ -43,52 +367,104 @@ auto parse_queue_trace(std::string trace_path) -> np::ndarray {
         throw std::logic_error("Wrong QUEUE_DTYPE size!");
     }
 
-    std::ifstream trace(trace_path, std::ios_base::in);
-    std::vector<QueueEvent> events{};
-    std::unordered_map<uint64_t, double> arrival_ts{};
-
-    char cmd;
-    std::string _;
-    while (trace >> cmd) {
-        QueueEvent ev;
-        std::string src, dst;
-        trace >> ev.ts >> _ >> _ >> _ >> ev.size >> _ >> ev.flow_id
-              >> src >> dst >> _ >> ev.id >> _ >> _ >> _ >> _;
+    auto const parse_chunk = [=] (Chunk chunk) {
+        QueueChunk result{};
+        auto& arrivals = result.pending_arrivals;
 
-        ev.src = stoul(src.substr(0, src.find('.')));
-        ev.dst = stoul(dst.substr(0, dst.find('.')));
-
-        switch (cmd) {
-            case '+': {
-                ev.event = ENQUEUE;
+        for (LineScanner line{chunk}; !line.at_end(); line.next_line()) {
+            auto const cmd = line.token();
+            if (cmd.size() != 1) {
+                continue;
             }
-                break;
-            case '-': {
-                ev.event = DEQUEUE;
+
+            QueueEvent ev{};
+            switch (cmd.front()) {
+                case '+':
+                    ev.event = ENQUEUE;
+                    break;
+                case '-':
+                    ev.event = DEQUEUE;
+                    break;
+                case 'd':
+                    ev.event = DROP;
+                    break;
+                default:
+                    continue;
             }
-                break;
-            case 'd': {
-                ev.event = DROP;
+
+            ev.ts = to_double(line.token());
+            ev.from_node = to_uint(line.token());
+            ev.to_node = to_uint(line.token());
+            ev.ptype = to_ptype(line.token());
+            ev.size = to_uint(line.token());
+            ev.flags = to_flags(line.token());
+            ev.flow_id = to_uint(line.token());
+            std::tie(ev.src, ev.sport) = to_endpoint(line.token());
+            std::tie(ev.dst, ev.dport) = to_endpoint(line.token());
+            ev.seqno = to_int(line.token());
+            ev.id = to_uint(line.token());
+
+            if (ev.event == ENQUEUE) {
+                arrivals[ev.id] = ev.ts;
+                ev.delay = std::numeric_limits<double>::infinity();
+            } else if (auto it = arrivals.find(ev.id); it != arrivals.end()) {
+                ev.delay = ev.ts - it->second;
+                arrivals.erase(it);
+            } else {
+                result.unmatched.push_back(result.events.size());
             }
-                break;
-            default:
-                continue;
+
+            result.events.push_back(ev);
         }
+        return result;
+    };
+
+    MappedFile const file{trace_path};
+    auto chunks = parse_chunks(file, parse_chunk);
 
-        if (ev.event == ENQUEUE) {
-            arrival_ts[ev.id] = ev.ts;
-            ev.delay = std::numeric_limits<double>::infinity();
-        } else {
+    std::unordered_map<uint64_t, double> arrival_ts{};
+    std::vector<std::vector<QueueEvent>> events{};
+    for (auto& chunk : chunks) {
+        for (auto idx : chunk.unmatched) {
+            auto& ev = chunk.events[idx];
             ev.delay = ev.ts - arrival_ts.at(ev.id);
             arrival_ts.erase(ev.id);
         }
+        for (auto const& [id, ts] : chunk.pending_arrivals) {
+            arrival_ts[id] = ts;
+        }
+        events.push_back(std::move(chunk.events));
+    }
 
-        events.push_back(ev);
+    return concatenate(QUEUE_DTYPE, events);
+}
+
+auto load_queue_trace(std::string trace_path) -> np::ndarray {
+    auto const tracing = py::import("tracing");
+    auto const QUEUE_DTYPE = np::dtype(tracing.attr("QueueTrace").attr("DTYPE"));
+
+    auto const file = std::make_shared<MappedFile>(trace_path);
+    auto const header = reinterpret_cast<QueueTraceHeader const *>(file->data());
+    if (file->size() < sizeof(QueueTraceHeader) ||
+            std::memcmp(header->magic, QUEUE_TRACE_MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != QUEUE_TRACE_VERSION ||
+            header->data_offset < sizeof(QueueTraceHeader) ||
+            header->data_offset > file->size()) {
+        throw std::runtime_error(trace_path + " is not a binary queue trace");
+    }
+    if (header->record_size != sizeof(QueueEvent) || 
+            QUEUE_DTYPE.get_itemsize() != sizeof(QueueEvent)) {
+        throw std::logic_error("Wrong QUEUE_DTYPE size!");
     }
-    auto const shape = py::make_tuple(events.size());
+
+    auto const num_events = 
+        (file->size() - header->data_offset) / sizeof(QueueEvent);
+    auto const shape = py::make_tuple(num_events);
     auto const strides = py::make_tuple(sizeof(QueueEvent));
-    auto const result = np::from_data(&events[0], QUEUE_DTYPE, shape, strides, py::object());
-    return result.copy();
+    auto const events = static_cast<void const *>(
+        file->data() + header->data_offset
+    );
+    return np::from_data(events, QUEUE_DTYPE, shape, strides, py::object(file));
 }
 
 struct CodelDrop {
@@ -112,26 +488,29 @@ auto parse_codel_drop_trace(std::string trace_path) -> np::ndarray {
         throw std::logic_error("Wrong CODEL_DROP_DTYPE size!");
     }
 
-    std::ifstream trace(trace_path, std::ios_base::in);
-    std::vector<CodelDrop> drops{};
+    auto const parse_chunk = [=] (Chunk chunk) {
+        std::vector<CodelDrop> drops{};
+        for (LineScanner line{chunk}; !line.at_end(); line.next_line()) {
+            auto const ts = line.token();
+            if (ts.empty()) {
+                continue;
+            }
 
-    CodelDrop temp{};
-    std::string reason_str{};
-    while (trace >> temp.ts >> reason_str) {
-        if (reason_str == "overflow") {
-            temp.reason = OVERFLOW_;
-        } else if (reason_str == "scheduled") {
-            temp.reason = SCHEDULED;
+            CodelDrop drop{};
+            drop.ts = to_double(ts);
+            auto const reason = line.token();
+            if (reason == "overflow") {
+                drop.reason = OVERFLOW_;
+            } else if (reason == "scheduled") {
+                drop.reason = SCHEDULED;
+            }
+            drops.push_back(drop);
         }
+        return drops;
+    };
 
-        drops.push_back(temp);
-    }
-
-    auto const shape = py::make_tuple(drops.size());
-    auto const strides = py::make_tuple(sizeof(CodelDrop));
-    auto const result = np::from_data(
-        &drops[0], CODEL_DROP_DTYPE, shape, strides, py::object());
-    return result.copy();
+    MappedFile const file{trace_path};
+    return concatenate(CODEL_DROP_DTYPE, parse_chunks(file, parse_chunk));
 }
 
 }
@@ -141,7 +520,11 @@ BOOST_PYTHON_MODULE(libtools)
     using namespace boost::python;
 
     numpy::initialize();
+    class_<MappedFile, std::shared_ptr<MappedFile>, boost::noncopyable>(
+        "MappedFile", no_init
+    );
     def("parse_queue_trace", &parse_queue_trace);
+    def("load_queue_trace", &load_queue_trace);
     def("parse_codel_drop_trace", &parse_codel_drop_trace);
 }
 
@@ -173,12 +173,20 @@ class QueueTrace(Trace):
                       ('ts', 'f8'),
                       ('id', 'u8'),
                       ('flow_id', 'u8'),
-                      ('delay', 'f8')], align=True)
+                      ('delay', 'f8'),
+                      ('from_node', 'u2'), ('to_node', 'u2'),
+                      ('ptype', 'u2'),
+                      ('flags', 'u2'),
+                      ('sport', 'i4'), ('dport', 'i4'),
+                      ('seqno', 'i4')], align=True)
 
     name = 'queue'
 
     @classmethod
     def parse(cls, ns2, temp_dir):
+        binary_source = path.join(temp_dir, f'{cls.name}.bin')
+        if path.exists(binary_source):
+            return libtools.load_queue_trace(binary_source)
         return libtools.parse_queue_trace(cls._get_trace_source(temp_dir))
 
 
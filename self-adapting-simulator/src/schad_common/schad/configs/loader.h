@@ -27,15 +27,16 @@ public:
             }
         };
         if (cfg.is_string()) {
-            auto file = path(cfg.get<string>());
-            if (!file.is_absolute()) {
-                file = working_dir_ / file;
-            }
+            auto const file = resolve(cfg.get<string>());
             return invoke(read_json(file), Loader{file.parent_path()});
         }
         return invoke(cfg, *this);
     }
 
+    auto resolve(path file) const -> path {
+        return file.is_absolute() ? file : working_dir_ / file;
+    }
+
     template<class Func>
     static auto load_from_dir(Func f, json const& cfg, 
             path working_dir = filesystem::current_path()) {
@@ -2,6 +2,7 @@
 #define PACKET_H
 
 #include <schad/common.h>
+#include <schad/packet/slab_pool.h>
 
 namespace schad {
 
@@ -9,30 +10,60 @@ struct Packet {
 private:
     struct tag;
 
+    struct Info {
+        uint32_t const id;
+        uint32_t const time_of_arrival;
+        uint32_t const initial_processing;
+        double const value;
+        optional<uint32_t> const slack;
+        uint32_t num_refs;
+
+        static auto operator new(size_t) -> void * {
+            return SlabPool<Info>::local().allocate();
+        }
+
+        static void operator delete(void * p) noexcept {
+            SlabPool<Info>::local().deallocate(p);
+        }
+    };
+
 public:
     Packet(tag, uint32_t id, uint32_t time_of_arrival,
            uint32_t initial_processing, double value, optional<uint32_t> slack) 
-        : id_{id}, time_of_arrival_{time_of_arrival}, 
-          initial_processing_{initial_processing}, value_{value}, slack_{slack},
+        : info_{new Info{id, time_of_arrival, initial_processing, value, slack, 1}},
           remaining_processing_{initial_processing} {
     }
 
+    Packet(tag, Info * info)
+        : info_{info}, remaining_processing_{info->initial_processing} {
+        info_->num_refs++;
+    }
+
+    Packet(Packet const&) = delete;
+    Packet& operator=(Packet const&) = delete;
+
+    ~Packet() {
+        if (--info_->num_refs == 0) {
+            delete info_;
+        }
+    }
+
     friend class PacketBuilder;
 
     auto id() const {
-        return id_;
+        return info_->id;
     }
 
     auto initial_processing() const {
-        return initial_processing_;
+        return info_->initial_processing;
     }
 
     auto time_of_arrival() const {
-        return time_of_arrival_;
+        return info_->time_of_arrival;
     }
 
     auto value() const {
-        return value_;
+        return info_->value;
     }
 
     auto remaining_processing() const {
@@ -45,25 +76,26 @@ public:
     }
 
     auto slack() const {
-        return slack_;
+        return info_->slack;
+    }
+
+    auto clone() const -> unique_ptr<Packet> {
+        return make_unique<Packet>(tag{}, info_); 
     }
 
-    auto clone() -> unique_ptr<Packet> {
-        return make_unique<Packet>(tag{}, id(), time_of_arrival(),
-           initial_processing(), value(), slack()); 
+    static auto operator new(size_t) -> void * {
+        return SlabPool<Packet>::local().allocate();
+    }
+
+    static void operator delete(void * p) noexcept {
+        SlabPool<Packet>::local().deallocate(p);
     }
 
 private:
     struct tag {};
 
 private:
-    uint32_t const id_;
-    uint32_t const time_of_arrival_;
-
-    uint32_t const initial_processing_;
-    double const value_;
-    optional<uint32_t> const slack_;
-
+    Info * const info_;
     uint32_t remaining_processing_; 
 };
 
@@ -0,0 +1,59 @@
+#ifndef SLAB_POOL_H
+#define SLAB_POOL_H
+
+#include <schad/common.h>
+
+namespace schad {
+
+template<class T, size_t slots_per_slab = 1024>
+class SlabPool {
+public:
+    SlabPool() : slabs_{}, free_{nullptr} {
+    }
+
+    SlabPool(SlabPool const&) = delete;
+    SlabPool& operator=(SlabPool const&) = delete;
+
+    auto allocate() -> void * {
+        if (free_ == nullptr) {
+            grow();
+        }
+        auto const slot = free_;
+        free_ = free_->next;
+        return slot->storage;
+    }
+
+    void deallocate(void * p) noexcept {
+        auto const slot = static_cast<Slot *>(p);
+        slot->next = free_;
+        free_ = slot;
+    }
+
+    static auto local() -> SlabPool& {
+        thread_local SlabPool pool{};
+        return pool;
+    }
+
+private:
+    union Slot {
+        Slot * next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    void grow() {
+        slabs_.emplace_back(make_unique<Slot[]>(slots_per_slab));
+        auto const slab = slabs_.back().get();
+        for (auto i = slots_per_slab; i > 0; --i) {
+            slab[i - 1].next = free_;
+            free_ = &slab[i - 1];
+        }
+    }
+
+private:
+    vector<unique_ptr<Slot[]>> slabs_;
+    Slot * free_;
+};
+
+}
+
+#endif // SLAB_POOL_H
@@ -0,0 +1,92 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <schad/common.h>
+
+#include <array>
+#include <limits>
+
+namespace schad {
+
+// Philox4x64-10 counter-based generator (Salmon et al., SC'11). The output
+// is a pure function of (key, counter), so streams with different keys are
+// independent.
+class Philox4x64 {
+public:
+    using result_type = uint64_t;
+    using ctr_type = std::array<uint64_t, 4>;
+    using key_type = std::array<uint64_t, 2>;
+
+    static constexpr auto min() -> result_type {
+        return 0;
+    }
+
+    static constexpr auto max() -> result_type {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    explicit Philox4x64(uint64_t key = 0, uint64_t stream = 0)
+        : key_{key, stream}, counter_{0}, block_{}, idx_{block_size} {
+    }
+
+    auto operator()() -> result_type {
+        if (idx_ == block_size) {
+            block_ = generate(counter_++);
+            idx_ = 0;
+        }
+        return block_[idx_++];
+    }
+
+    template<class OutputIt>
+    void fill(OutputIt out, size_t n) {
+        for (; n > 0 && idx_ != block_size; --n) {
+            *out++ = block_[idx_++];
+        }
+        for (; n >= block_size; n -= block_size) {
+            for (auto x : generate(counter_++)) {
+                *out++ = x;
+            }
+        }
+        for (; n > 0; --n) {
+            *out++ = (*this)();
+        }
+    }
+
+    // The Philox4x64-10 bijection of Random123: maps a 256-bit counter to
+    // 256 random bits under a 128-bit key.
+    static auto block(ctr_type ctr, key_type key) -> ctr_type {
+        for (auto round = 0; round < 10; ++round) {
+            auto const p0 = (unsigned __int128) 0xD2E7470EE14C6C93ull * ctr[0];
+            auto const p1 = (unsigned __int128) 0xCA5A826395121157ull * ctr[2];
+            ctr = {
+                uint64_t(p1 >> 64) ^ ctr[1] ^ key[0], uint64_t(p1),
+                uint64_t(p0 >> 64) ^ ctr[3] ^ key[1], uint64_t(p0)
+            };
+            key[0] += 0x9E3779B97F4A7C15ull;
+            key[1] += 0xBB67AE8584CAA73Bull;
+        }
+        return ctr;
+    }
+
+private:
+    static constexpr size_t block_size = 4;
+    using block_t = ctr_type;
+
+    auto generate(uint64_t counter) const -> block_t {
+        return block({counter, 0, 0, 0}, key_);
+    }
+
+private:
+    key_type key_;
+    uint64_t counter_;
+    block_t block_;
+    size_t idx_;
+};
+
+inline auto to_unit_interval(uint64_t bits) -> double {
+    return (bits >> 11) * 0x1.0p-53;
+}
+
+}
+
+#endif // PHILOX_H
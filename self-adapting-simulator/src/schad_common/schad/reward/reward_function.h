@@ -8,6 +8,7 @@ namespace schad {
 struct RewardFunction {
     virtual void note_transmission(uint32_t time, Packet const& p) = 0;
     virtual void note_arrival(Packet const& p) = 0;
+    virtual void note_arrivals(vector<unique_ptr<Packet>> const& packets) = 0;
 
     virtual auto get() const -> Reward = 0;
     virtual void reset(vector<Packet const*> const& buffer) = 0;
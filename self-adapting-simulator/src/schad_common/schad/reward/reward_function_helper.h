@@ -0,0 +1,20 @@
+#ifndef REWARD_FUNCTION_HELPER_H
+#define REWARD_FUNCTION_HELPER_H
+
+#include <schad/reward/reward_function.h>
+
+namespace schad {
+
+template<class Derived>
+struct RewardFunctionHelper : RewardFunction {
+    void note_arrivals(vector<unique_ptr<Packet>> const& packets) final {
+        auto& self = static_cast<Derived&>(*this);
+        for (auto const& p : packets) {
+            self.Derived::note_arrival(*p);
+        }
+    }
+};
+
+}
+
+#endif // REWARD_FUNCTION_HELPER_H
@@ -0,0 +1,78 @@
+#include <schad/random/philox.h>
+
+#include <cstdio>
+
+namespace {
+
+struct KnownAnswer {
+    schad::Philox4x64::ctr_type ctr;
+    schad::Philox4x64::key_type key;
+    schad::Philox4x64::ctr_type expected;
+};
+
+// The philox4x64_10 vectors of Random123's kat_vectors.
+KnownAnswer const known_answers[] = {
+    {
+        {0, 0, 0, 0},
+        {0, 0},
+        {0x16554d9eca36314cull, 0xdb20fe9d672d0fdcull,
+         0xd7e772cee186176bull, 0x7e68b68aec7ba23bull}
+    },
+    {
+        {~0ull, ~0ull, ~0ull, ~0ull},
+        {~0ull, ~0ull},
+        {0x87b092c3013fe90bull, 0x438c3c67be8d0224ull,
+         0x9cc7d7c69cd777b6ull, 0xa09caebf594f0ba0ull}
+    },
+    {
+        {0x243f6a8885a308d3ull, 0x13198a2e03707344ull,
+         0xa4093822299f31d0ull, 0x082efa98ec4e6c89ull},
+        {0x452821e638d01377ull, 0xbe5466cf34e90c6cull},
+        {0xa528f45403e61d95ull, 0x38c72dbd566e9788ull,
+         0xa5a1610e72fd18b5ull, 0x57bd43b5e52b7fe6ull}
+    },
+};
+
+}
+
+int main() {
+    auto failed = 0;
+    for (auto const& kat : known_answers) {
+        if (schad::Philox4x64::block(kat.ctr, kat.key) != kat.expected) {
+            std::printf("philox4x64_10 %016llx: wrong block\n",
+                (unsigned long long) kat.ctr[0]);
+            failed++;
+        }
+    }
+
+    // The engine walks the counters {0, 0, 0, 0}, {1, 0, 0, 0}, ... and
+    // fill() agrees with successive calls, whatever the alignment.
+    schad::Philox4x64 engine{0x452821e638d01377ull, 0xbe5466cf34e90c6cull};
+    uint64_t bits[11];
+    for (auto& x : bits) {
+        x = engine();
+    }
+    for (auto i = 0u; i < 3; ++i) {
+        auto const expected = schad::Philox4x64::block(
+            {i, 0, 0, 0}, {0x452821e638d01377ull, 0xbe5466cf34e90c6cull}
+        );
+        for (auto j = 0u; j < 4 && 4 * i + j < 11; ++j) {
+            if (bits[4 * i + j] != expected[j]) {
+                std::printf("philox4x64_10 engine: wrong output %u\n", 4 * i + j);
+                failed++;
+            }
+        }
+    }
+    schad::Philox4x64 filled{0x452821e638d01377ull, 0xbe5466cf34e90c6cull};
+    uint64_t fill_bits[11];
+    fill_bits[0] = filled();
+    filled.fill(fill_bits + 1, 10);
+    for (auto i = 0u; i < 11; ++i) {
+        if (fill_bits[i] != bits[i]) {
+            std::printf("philox4x64_10 fill: wrong output %u\n", i);
+            failed++;
+        }
+    }
+
+    return failed == 0 ? 0 : 1;
+}
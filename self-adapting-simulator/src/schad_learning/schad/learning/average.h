@@ -7,19 +7,29 @@
 namespace schad::learning {
 
 struct SlidingWindow {
-    explicit SlidingWindow(size_t num_steps) : num_steps_{num_steps} { }
+    explicit SlidingWindow(size_t num_steps, bool compensated = false) 
+        : num_steps_{num_steps}, compensated_{compensated} { 
+    }
 
     auto num_steps() const {
         return num_steps_;
     }
 
+    auto compensated() const {
+        return compensated_;
+    }
+
 private:
     size_t num_steps_;
+    bool compensated_;
 };
 
 inline void to_json(json& j, SlidingWindow const& sw) {
     j = {{"type", "sliding_window"},
         {"num_steps", sw.num_steps()}};
+    if (sw.compensated()) {
+        j["compensated"] = true;
+    }
 }
 
 struct Exponential {
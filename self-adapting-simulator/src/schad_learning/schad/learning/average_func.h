@@ -2,7 +2,6 @@
 #define AVERAGE_FUNC_H
 
 #include <schad/learning/average.h>
-#include <queue>
 
 namespace schad::learning {
 
@@ -11,32 +10,38 @@ template<class Average, bool squares = false> struct AverageFunc;
 template<bool squares>
 struct AverageFunc<SlidingWindow, squares> {
     explicit AverageFunc(SlidingWindow const& params) 
-        : params_{params}, history_{}, current_value_{0.0}, current_count_{0} {
+        : params_{params}, values_{}, present_{}, oldest_{0}, 
+          current_value_{0.0}, compensation_{0.0}, current_count_{0} {
     }
 
     void operator+=(optional<double> value) {
-        history_.push(value);
-
+        auto const x = value.has_value() ? transform(*value) : 0.0;
         if (value.has_value()) {
-            if constexpr (squares) {
-                current_value_ += *value * *value;
-            } else {
-                current_value_ += *value;
-            }
+            add(x);
             current_count_ += 1;
         }
 
-        if (history_.size() > params_.num_steps()) {
-            if (history_.front().has_value()) {
-                if constexpr (squares) {
-                    current_value_ -= *history_.front() * *history_.front();
-                } else {
-                    current_value_ -= *history_.front();
-                }
+        if (values_.size() < params_.num_steps()) {
+            set_present(values_.size(), value.has_value());
+            values_.push_back(x);
+            return;
+        }
+
+        if (values_.empty()) {
+            if (value.has_value()) {
+                add(-x);
                 current_count_ -= 1;
             }
-            history_.pop();
+            return;
+        }
+
+        if (is_present(oldest_)) {
+            add(-values_[oldest_]);
+            current_count_ -= 1;
         }
+        values_[oldest_] = x;
+        set_present(oldest_, value.has_value());
+        oldest_ = oldest_ + 1 == values_.size() ? 0 : oldest_ + 1;
     }
 
     auto avg() const -> double {
@@ -47,10 +52,49 @@ struct AverageFunc<SlidingWindow, squares> {
         return current_count_;
     }
 
+private:
+    static auto transform(double value) -> double {
+        if constexpr (squares) {
+            return value * value;
+        } else {
+            return value;
+        }
+    }
+
+    void add(double x) {
+        if (params_.compensated()) {
+            auto const y = x - compensation_;
+            auto const t = current_value_ + y;
+            compensation_ = (t - current_value_) - y;
+            current_value_ = t;
+        } else {
+            current_value_ += x;
+        }
+    }
+
+    auto is_present(size_t idx) const -> bool {
+        return (present_[idx / 64] >> (idx % 64)) & 1u;
+    }
+
+    void set_present(size_t idx, bool present) {
+        if (idx / 64 == present_.size()) {
+            present_.push_back(0);
+        }
+        auto const mask = uint64_t{1} << (idx % 64);
+        if (present) {
+            present_[idx / 64] |= mask;
+        } else {
+            present_[idx / 64] &= ~mask;
+        }
+    }
+
 private:
     SlidingWindow const params_;
-    std::queue<optional<double>> history_;
+    vector<double> values_;
+    vector<uint64_t> present_;
+    size_t oldest_;
     double current_value_;
+    double compensation_;
     size_t current_count_;
 };
 
@@ -21,7 +21,18 @@ public:
 
     auto choose() -> vector<size_t> override {
         auto const exploited = exploiter_->choose().front();
-        auto result = explorer_->choose();
+        return combine(exploited, explorer_->choose());
+    }
+
+    auto choose_top(size_t num_top) -> vector<size_t> override {
+        auto const exploited = exploiter_->choose_top(1).front();
+        auto result = combine(exploited, explorer_->choose_top(num_top));
+        result.resize(std::min(result.size(), num_top));
+        return result;
+    }
+
+private:
+    static auto combine(size_t exploited, vector<size_t> result) -> vector<size_t> {
         auto expl_it = std::find(begin(result), end(result), exploited);
 
         if (expl_it == end(result)) {
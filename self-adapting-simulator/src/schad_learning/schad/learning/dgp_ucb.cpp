@@ -1,6 +1,7 @@
 #include "dgp_ucb.h"
 #include <schad/learning/learning_method_factory_helper.h>
 #include <schad/learning/average_func.h>
+#include <schad/learning/top_arms.h>
 
 
 namespace {
@@ -16,45 +17,36 @@ private:
 public:
     DGPUCBLearningMethod(double delta, double ksi, Average avg, size_t num_arms)
         : delta_{delta}, ksi_{ksi}, init_arm_{0}, 
-         us_(num_arms), total_(num_arms), ucb_counts_(num_arms, Avg{avg}) {
+         us_(num_arms), total_(num_arms), ucb_counts_(num_arms, Avg{avg}),
+         counts_(num_arms), prios_(num_arms) {
     }
 
     auto choose() -> vector<size_t> override {
+        return choose_top(us_.size());
+    }
+
+    auto choose_top(size_t num_top) -> vector<size_t> override {
         if (init_arm_ < us_.size()) {
             return {init_arm_++};
         }
 
-        
-        auto const get_count = [this](auto i) {
+        auto total_count = 0.0;
+        for (auto i = 0u; i < us_.size(); i++) {
             if constexpr(ucb_counts) {
-                return ucb_counts_[i].count();
+                counts_[i] = ucb_counts_[i].count();
             } else {
-                return total_[i];
+                counts_[i] = total_[i];
             }
-        };
-
-        auto const total_count = [this,get_count]() {
-            auto count = 0.0;
-            for (auto i = 0u; i < us_.size(); i++) {
-                count += get_count(i);
-            }
-            return count;
-        }();
-
-
-        auto get_prio = [this,total_count,get_count] (auto i) {
-            return us_[i] / (total_[i] + 0.0001) 
-                + sqrt(ksi_ * log(total_count) / get_count(i));
-        };
-
-        vector<size_t> result(us_.size());
-        std::iota(begin(result), end(result), 0);
+            total_count += counts_[i];
+        }
+        auto const log_total_count = log(total_count);
 
-        sort(begin(result), end(result), [get_prio](auto a, auto b) {
-            return get_prio(a) > get_prio(b);
-        });
+        for (auto i = 0u; i < us_.size(); i++) {
+            prios_[i] = us_[i] / (total_[i] + 0.0001) 
+                + sqrt(ksi_ * log_total_count / counts_[i]);
+        }
 
-        return result;
+        return top_arms(prios_, num_top);
     }
 
     void report_rewards(vector<optional<Reward>> const& rewards) override {
@@ -80,6 +72,8 @@ private:
     vector<double> us_;
     vector<double> total_;
     vector<Avg> ucb_counts_;
+    vector<double> counts_;
+    vector<double> prios_;
 };
 
 }
@@ -23,7 +23,10 @@ namespace schad::learning {
         } else if (average.at("type") == "exponential") {
             avg = learning::Exponential{average.at("gamma").get<double>()};
         } else if (average.at("type") == "sliding_window") {
-            avg = learning::SlidingWindow{average.at("num_steps").get<size_t>()};
+            avg = learning::SlidingWindow{
+                average.at("num_steps").get<size_t>(),
+                average.value("compensated", false)
+            };
         } else {
             throw std::invalid_argument("Unknown UCB averager!");
         }
@@ -9,6 +9,12 @@ struct LearningMethod {
     virtual void report_rewards(vector<optional<Reward>> const& rewards) = 0;
     virtual auto choose() -> vector<size_t> = 0;
 
+    virtual auto choose_top(size_t num_arms) -> vector<size_t> {
+        auto result = choose();
+        result.resize(std::min(result.size(), num_arms));
+        return result;
+    }
+
     LearningMethod() = default; 
 
     LearningMethod(LearningMethod const&) = delete;
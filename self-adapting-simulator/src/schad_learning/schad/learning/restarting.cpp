@@ -21,13 +21,23 @@ public:
     }
 
     auto choose() -> vector<size_t> override {
+        next_step();
+        return base_->choose();
+    }
+
+    auto choose_top(size_t num_top) -> vector<size_t> override {
+        next_step();
+        return base_->choose_top(num_top);
+    }
+
+private:
+    void next_step() {
         num_steps_phase_++;
         if (num_steps_phase_ == num_steps_) {
             restart();
         }
-        return base_->choose();
     }
-private:
+
     void restart() {
         base_ = restarter_();
         num_steps_phase_ = 0;
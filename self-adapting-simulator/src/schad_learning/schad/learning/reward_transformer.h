@@ -30,6 +30,10 @@ public:
         return base_->choose();
     }
 
+    auto choose_top(size_t num_top) -> vector<size_t> override {
+        return base_->choose_top(num_top);
+    }
+
 private:
     Func const func_;
     unique_ptr<LearningMethod> const base_;
@@ -0,0 +1,34 @@
+#ifndef TOP_ARMS_H
+#define TOP_ARMS_H
+
+#include <schad/common.h>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace schad::learning {
+
+inline auto top_arms(vector<double> const& prios, size_t num_top) -> vector<size_t> {
+    auto const key = [&prios] (auto i) {
+        return std::isnan(prios[i]) 
+            ? -std::numeric_limits<double>::infinity() : prios[i];
+    };
+    auto const better = [key] (auto a, auto b) {
+        return key(a) > key(b) || (key(a) == key(b) && a < b);
+    };
+
+    vector<size_t> result(prios.size());
+    std::iota(begin(result), end(result), 0);
+    num_top = std::min(num_top, result.size());
+
+    if (num_top == 1) {
+        return {*std::min_element(begin(result), end(result), better)};
+    }
+    std::partial_sort(begin(result), begin(result) + num_top, end(result), better);
+    result.resize(num_top);
+    return result;
+}
+
+}
+
+#endif // TOP_ARMS_H
@@ -30,10 +30,10 @@ public:
         }
     }
 
-    auto get_prio() {
-        return [this,total_count=this->total_count()] (auto i) {
-                return this->value(i).avg() 
-                    + sqrt(ksi_ * log(total_count) / this->count(i));
+    template<class Stats>
+    auto get_prio(Stats const& s) {
+        return [&s,ksi=ksi_] (auto i) {
+                return s.avg[i] + sqrt(ksi * s.log_total_count / s.count[i]);
         };
     }
 
@@ -3,6 +3,7 @@
 
 #include <schad/learning/learning_method.h>
 #include <schad/learning/average_func.h>
+#include <schad/learning/top_arms.h>
 
 namespace schad::learning {
 
@@ -14,8 +15,17 @@ struct UCBCommon : public LearningMethod {
 
     using Avg = AverageFunc<Average>;
 
+    struct ArmStatistics {
+        vector<double> avg;
+        vector<double> count;
+        double total_count;
+        double log_total_count;
+    };
+
     UCBCommon(size_t num_arms, Average avg) : 
-        num_arms_{num_arms}, init_arm_{0}, values_(num_arms, Avg{avg}) {
+        num_arms_{num_arms}, init_arm_{0}, values_(num_arms, Avg{avg}),
+        stats_{vector<double>(num_arms), vector<double>(num_arms), 0.0, 0.0},
+        prios_(num_arms) {
     }
 
     void report_rewards(vector<optional<Reward>> const& rewards) override {
@@ -28,19 +38,30 @@ struct UCBCommon : public LearningMethod {
     }
 
     auto choose() -> vector<size_t> override {
+        return choose_top(num_arms_);
+    }
+
+    auto choose_top(size_t num_top) -> vector<size_t> override {
         if (init_arm_ < num_arms_) {
             if constexpr(Derived::need_choice) {
                 static_cast<Derived *>(this)->report_choice({init_arm_});
             }
             return {init_arm_++};
         }
-        auto const get_prio = static_cast<Derived *>(this)->get_prio();
-        vector<size_t> result(num_arms_);
-        std::iota(begin(result), end(result), 0);
 
-        sort(begin(result), end(result), [get_prio](auto a, auto b) {
-            return get_prio(a) > get_prio(b);
-        });
+        stats_.total_count = 0.0;
+        for (auto i = 0u; i < num_arms_; i++) {
+            stats_.avg[i] = values_[i].avg();
+            stats_.count[i] = count(i);
+            stats_.total_count += stats_.count[i];
+        }
+        stats_.log_total_count = log(stats_.total_count);
+
+        auto const get_prio = static_cast<Derived *>(this)->get_prio(stats_);
+        for (auto i = 0u; i < num_arms_; i++) {
+            prios_[i] = get_prio(i);
+        }
+        auto const result = top_arms(prios_, num_top);
 
         if constexpr(Derived::need_choice) {
             static_cast<Derived *>(this)->report_choice(result);
@@ -49,14 +70,6 @@ struct UCBCommon : public LearningMethod {
         return result;
     }
 
-    auto total_count() const {
-        double total = 0;
-        for (int i = 0; i < int(num_arms_); i++) {
-            total += count(i);
-        }
-        return total;
-    }
-
     auto count(size_t i) const {
         if constexpr(Derived::provides_special_count) {
             return static_cast<Derived const *>(this)->special_count(i);
@@ -73,6 +86,8 @@ private:
     size_t const num_arms_;
     size_t init_arm_;
     vector<Avg> values_;
+    ArmStatistics stats_;
+    vector<double> prios_;
 };
 
 }
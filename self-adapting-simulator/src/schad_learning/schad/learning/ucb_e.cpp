@@ -15,9 +15,10 @@ public:
         , a_{a} {
     }
 
-    auto get_prio() {
-        return [this] (auto i) {
-            return this->value(i).avg() + sqrt(a_ / this->count(i));
+    template<class Stats>
+    auto get_prio(Stats const& s) {
+        return [&s,a=a_] (auto i) {
+            return s.avg[i] + sqrt(a / s.count[i]);
         };
     }
 
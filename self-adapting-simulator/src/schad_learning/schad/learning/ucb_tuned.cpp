@@ -16,18 +16,22 @@ public:
 
     UCBTunedLearningMethod(size_t num_arms, Average avg)
         : UCBCommon<UCBTunedLearningMethod<Average>, Average>(num_arms, avg),
-          squares_(num_arms, AvgSq{avg}) {
+          squares_(num_arms, AvgSq{avg}), squares_avg_(num_arms) {
     }
 
     void report_reward(optional<double> const& reward, size_t arm) {
         squares_[arm] += reward;
     }
 
-    auto get_prio() {
-        return [total_count=this->total_count(),this] (auto i) {
-            return this->value(i).avg() + sqrt(log(total_count) / this->count(i) * 
-                std::min(0.25, squares_[i].avg() - this->value(i).avg() * this->value(i).avg() 
-                    + sqrt(2.0 * log(total_count) / this->count(i))
+    template<class Stats>
+    auto get_prio(Stats const& s) {
+        for (auto i = 0u; i < squares_.size(); i++) {
+            squares_avg_[i] = squares_[i].avg();
+        }
+        return [&s,this] (auto i) {
+            return s.avg[i] + sqrt(s.log_total_count / s.count[i] * 
+                std::min(0.25, squares_avg_[i] - s.avg[i] * s.avg[i] 
+                    + sqrt(2.0 * s.log_total_count / s.count[i])
                 )
             );
         };
@@ -35,6 +39,7 @@ public:
 
 private:
     vector<AvgSq> squares_;
+    vector<double> squares_avg_;
 };
 
 }
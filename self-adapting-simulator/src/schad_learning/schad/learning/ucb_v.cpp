@@ -16,23 +16,27 @@ public:
 
     UCBVLearningMethod(size_t num_arms, Average avg) 
         : UCBCommon<std::decay_t<decltype(*this)>, Average>(num_arms, avg)
-        , squares_(num_arms, AvgSq{avg}) {
+        , squares_(num_arms, AvgSq{avg}), squares_avg_(num_arms) {
     }
 
     void report_reward(optional<double> const& reward, size_t arm) {
         squares_[arm] += reward;
     }
 
-    auto get_prio() {
-        return [total_count=this->total_count(),this] (auto i) {
-            return this->value(i).avg() + sqrt(2 * log(total_count) / this->count(i) *
-                    (squares_[i].avg() - this->value(i).avg() * this->value(i).avg())
-                    ) + log(total_count) / this->count(i);
-                     
+    template<class Stats>
+    auto get_prio(Stats const& s) {
+        for (auto i = 0u; i < squares_.size(); i++) {
+            squares_avg_[i] = squares_[i].avg();
+        }
+        return [&s,this] (auto i) {
+            return s.avg[i] + sqrt(2 * s.log_total_count / s.count[i] *
+                    (squares_avg_[i] - s.avg[i] * s.avg[i])
+                    ) + s.log_total_count / s.count[i];
         };
     }
 private:
     vector<AvgSq> squares_;
+    vector<double> squares_avg_;
 };
 
 }
@@ -0,0 +1,459 @@
+#include <boost/program_options.hpp>
+
+#include <schad/learning/learning_config.h>
+#include <schad/configs/source_config.h>
+#include <schad/configs/experiment_config.h>
+#include <schad/policy/pq_policy.h>
+#include <schad/traffic/poisson_source.h>
+#include <schad/simulator/simulation.h>
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef SCHAD_TESTS_DIR
+#define SCHAD_TESTS_DIR "tests"
+#endif
+
+namespace {
+
+using namespace schad;
+using bench_clock = std::chrono::steady_clock;
+
+auto elapsed_ns(bench_clock::time_point since) -> double {
+    return std::chrono::duration<double, std::nano>(bench_clock::now() - since).count();
+}
+
+class BenchWorld : public World {
+public:
+    explicit BenchWorld(uint64_t seed)
+        : time_{0}, rng_{make_shared<rng_t>(seed)} {
+    }
+
+    auto current_time() const -> uint32_t override {
+        return time_;
+    }
+
+    auto rng() -> shared_ptr<rng_t> const& override {
+        return rng_;
+    }
+
+    void tick() {
+        time_++;
+    }
+
+private:
+    uint32_t time_;
+    shared_ptr<rng_t> rng_;
+};
+
+class DiscardingStatsSink : public StatsSink {
+public:
+    using StatsSink::StatsSink;
+
+protected:
+    void write([[maybe_unused]] RunStatistics run) override {
+    }
+};
+
+// Arrivals overload the buffer (1.5 packets of up to 4 units of work per
+// step against one unit of service) and the slack is long enough for even
+// the largest buffer to fill up, so admission keeps dropping packets.
+auto policy_traffic() -> unique_ptr<SourceFactory> {
+    return create_poisson_source(PoissonSourceParameters{1.5}
+        .set_min_value(1).set_max_value(100)
+        .set_min_work(1).set_max_work(4)
+        .set_min_slack(1.0).set_max_slack(1000.0)
+    );
+}
+
+auto bench_policy(shared_ptr<Policy> const& policy, PQBackend backend,
+        size_t buffer_size, double min_ns) -> json {
+    constexpr auto steps_per_round = 1024u;
+
+    BenchWorld world{1};
+    auto const instance = policy->instantiate(&world, buffer_size);
+    auto const src = policy_traffic()->instantiate(world.rng());
+
+    for (auto i = 0u; i < buffer_size; ++i) {
+        instance->admit_n_drop(src->next(world.current_time()));
+        world.tick();
+    }
+
+    double admit_ns = 0.0, service_ns = 0.0;
+    uint64_t num_steps = 0, num_arrived = 0, num_dropped = 0, num_buffered = 0;
+    vector<vector<unique_ptr<Packet>>> arrivals(steps_per_round);
+    while (admit_ns + service_ns < min_ns) {
+        for (auto& packets : arrivals) {
+            packets = src->next(world.current_time());
+        }
+        for (auto& packets : arrivals) {
+            num_arrived += packets.size();
+
+            auto const admit_start = bench_clock::now();
+            auto const dropped = instance->admit_n_drop(std::move(packets));
+            admit_ns += elapsed_ns(admit_start);
+            num_dropped += dropped.size();
+
+            auto const service_start = bench_clock::now();
+            auto const next = instance->select_for_processing();
+            if (next != nullptr) {
+                next->process();
+                instance->processing_finished(next);
+            }
+            auto const transmitted = instance->transmit();
+            service_ns += elapsed_ns(service_start);
+
+            num_buffered += instance->num_packets_in_buffer();
+            world.tick();
+        }
+        num_steps += steps_per_round;
+    }
+
+    return {
+        {"policy", policy->name()},
+        {"backend", pq_backend_name(backend)},
+        {"buffer_size", buffer_size},
+        {"admit_ns_per_packet", admit_ns / std::max<uint64_t>(num_arrived, 1)},
+        {"service_ns_per_step", service_ns / num_steps},
+        {"drop_ratio", double(num_dropped) / std::max<uint64_t>(num_arrived, 1)},
+        {"mean_buffered", double(num_buffered) / num_steps}
+    };
+}
+
+auto bench_policies(double min_ns) -> json {
+    auto result = json::array();
+    for (auto buffer_size : {16u, 64u, 256u, 1024u}) {
+        for (auto kind : {BuiltInPQKind::WORK, BuiltInPQKind::VALUE,
+                BuiltInPQKind::VALUE_PER_WORK, BuiltInPQKind::VALUE_PER_SLACK,
+                BuiltInPQKind::DEADLINE}) {
+            for (auto backend : {PQBackend::SCAN, PQBackend::HEAP}) {
+                result.push_back(bench_policy(
+                    get_builtin_pq(kind, backend), backend, buffer_size, min_ns
+                ));
+            }
+        }
+    }
+    return result;
+}
+
+auto learning_configs() -> vector<pair<string, json>> {
+    json const average = {{"type", "exponential"}, {"gamma", 0.9}};
+    json const ucb = {
+        {"type", "ucb"},
+        {"parameters", {
+            {"ksi", 2.0}, {"average", average}, {"restricted_exploration", false}
+        }}
+    };
+    return {
+        {"ucb", ucb},
+        {"epsilon_greedy", {{"type", "epsilon_greedy"}, {"parameters", {
+            {"epsilon", 0.1}, {"average", average}, {"delta", 0.0}, {"sigma", 0.0}
+        }}}},
+        {"constant", {{"type", "constant"}, {"parameters", {{"arm_idx", 0}}}}},
+        {"combined", {{"type", "combined"}, {"parameters", {
+            {"exploiter", ucb}, {"explorer", ucb}
+        }}}},
+        {"restarting", {{"type", "restarting"}, {"parameters", {
+            {"base", ucb}, {"num_steps", 1000}
+        }}}},
+        {"ucb_e", {{"type", "ucb_e"}, {"parameters", {{"a", 2.0}}}}},
+        {"dgp_ucb", {{"type", "dgp_ucb"}, {"parameters", {
+            {"delta", 0.1}, {"ksi", 2.0}, {"average", average}
+        }}}},
+        {"softmax", {{"type", "softmax"}, {"parameters", {{"alpha", 1.0}}}}},
+        {"normalized", {{"type", "normalized"}, {"parameters", {{"base", ucb}}}}},
+        {"ucb_tuned", {{"type", "ucb_tuned"}, {"parameters", {{"average", average}}}}},
+        {"ucb_v", {{"type", "ucb_v"}, {"parameters", {{"average", average}}}}},
+        {"scaled", {{"type", "scaled"}, {"parameters", {
+            {"base", ucb}, {"factor", 0.5}
+        }}}},
+        {"explore_exploit", {{"type", "explore_exploit"}, {"parameters", {
+            {"time_limit", 100},
+            {"base", {{"type", "successive_rejects"}, {"parameters", json::object()}}}
+        }}}},
+        {"local_greedy", {{"type", "local_greedy"}, {"parameters", json::object()}}}
+    };
+}
+
+auto bench_learning_method(string const& name, json const& cfg,
+        size_t num_arms, double min_ns) -> json {
+    constexpr auto rounds_per_check = 256u;
+
+    auto const factory = Loader::load_from_dir(load_learning_method, cfg);
+    auto rng = make_shared<rng_t>(1);
+    auto const method = factory->instantiate(rng, num_arms);
+
+    std::uniform_real_distribution<double> noise{0.0, 1.0};
+    vector<optional<Reward>> rewards(num_arms);
+    double choose_ns = 0.0, report_ns = 0.0;
+    uint64_t num_rounds = 0;
+    while (choose_ns + report_ns < min_ns) {
+        for (auto i = 0u; i < rounds_per_check; ++i) {
+            auto const choose_start = bench_clock::now();
+            auto const chosen = method->choose().front();
+            choose_ns += elapsed_ns(choose_start);
+
+            std::fill(begin(rewards), end(rewards), std::nullopt);
+            rewards[chosen] = Reward{double(chosen + 1) / num_arms + noise(*rng)};
+
+            auto const report_start = bench_clock::now();
+            method->report_rewards(rewards);
+            report_ns += elapsed_ns(report_start);
+        }
+        num_rounds += rounds_per_check;
+    }
+
+    return {
+        {"method", name},
+        {"num_arms", num_arms},
+        {"choose_ns", choose_ns / num_rounds},
+        {"report_ns", report_ns / num_rounds}
+    };
+}
+
+auto bench_learning(double min_ns) -> json {
+    auto result = json::array();
+    for (auto const& [name, cfg] : learning_configs()) {
+        for (auto num_arms : {2u, 8u, 32u, 128u}) {
+            result.push_back(bench_learning_method(name, cfg, num_arms, min_ns));
+        }
+    }
+    return result;
+}
+
+auto bench_source(SourceFactory const& factory, double min_ns) -> json {
+    constexpr auto steps_per_check = 1024u;
+
+    auto const src = factory.instantiate(make_shared<rng_t>(1));
+    double next_ns = 0.0;
+    uint32_t time = 0;
+    uint64_t num_packets = 0;
+    while (next_ns < min_ns) {
+        auto const start = bench_clock::now();
+        for (auto i = 0u; i < steps_per_check; ++i) {
+            num_packets += src->next(time++).size();
+        }
+        next_ns += elapsed_ns(start);
+    }
+
+    return {
+        {"ns_per_step", next_ns / time},
+        {"packets_per_step", double(num_packets) / time}
+    };
+}
+
+auto read_json(path const& file) -> json {
+    json result{};
+    std::ifstream is{file.native()};
+    is >> result;
+    return result;
+}
+
+auto bench_sources(vector<path> const& configs, double min_ns) -> json {
+    auto result = json::array();
+    for (auto const& config : configs) {
+        json entry{};
+        try {
+            auto const factory = Loader::load_from_dir(
+                load_source, read_json(config), config.parent_path()
+            );
+            entry = bench_source(*factory, min_ns);
+        } catch (unknown_source_exception const&) {
+            // Learning method configs share the directory with sources.
+            continue;
+        } catch (std::exception const& e) {
+            entry = {{"error", e.what()}};
+        }
+        entry["source"] = config.filename().string();
+        result.push_back(entry);
+    }
+
+    auto const block = create_poisson_source(PoissonSourceParameters{5.0}
+        .set_min_value(1).set_max_value(100)
+        .set_min_slack(0.0).set_max_slack(50.0)
+        .set_block_size(256)
+    );
+    auto entry = bench_source(*block, min_ns);
+    entry["source"] = "poisson/block_size=256";
+    result.push_back(entry);
+    return result;
+}
+
+struct ExperimentOverrides {
+    optional<size_t> num_runs;
+    optional<size_t> num_time_steps;
+    size_t num_threads;
+};
+
+auto run_experiment(path const& config, ExperimentOverrides const& overrides) -> json {
+    auto experiment = Loader::load_from_dir(
+        load_experiment, read_json(config), config.parent_path()
+    );
+    auto sim_params = experiment.simulation_parameters();
+    if (overrides.num_runs) {
+        sim_params.set_num_runs(*overrides.num_runs);
+    }
+    if (overrides.num_time_steps) {
+        sim_params.set_num_time_steps(*overrides.num_time_steps);
+    }
+    experiment.set_simulation_parameters(sim_params);
+
+    DiscardingStatsSink sink{experiment.policies().size()};
+    auto const start = bench_clock::now();
+    run(experiment, sink, overrides.num_threads);
+    auto const wall_seconds = elapsed_ns(start) * 1e-9;
+
+    auto const num_steps = sim_params.num_runs() * sim_params.num_time_steps();
+    return {
+        {"num_runs", sim_params.num_runs()},
+        {"num_time_steps", sim_params.num_time_steps()},
+        {"wall_seconds", wall_seconds},
+        {"steps_per_second", num_steps / wall_seconds}
+    };
+}
+
+// Every experiment runs in a child process so that its peak RSS is not
+// masked by the high-water mark of the experiments before it.
+auto bench_experiment(path const& config, ExperimentOverrides const& overrides) -> json {
+    int fds[2];
+    if (::pipe(fds) != 0) {
+        throw std::runtime_error("pipe failed: " + string(std::strerror(errno)));
+    }
+
+    std::cout.flush();
+    auto const pid = ::fork();
+    if (pid < 0) {
+        throw std::runtime_error("fork failed: " + string(std::strerror(errno)));
+    }
+    if (pid == 0) {
+        ::close(fds[0]);
+        json entry{};
+        auto status = 0;
+        try {
+            entry = run_experiment(config, overrides);
+        } catch (std::exception const& e) {
+            entry = {{"error", e.what()}};
+            status = 1;
+        }
+        auto const out = entry.dump();
+        for (size_t written = 0; written < out.size(); ) {
+            auto const n = ::write(fds[1], out.data() + written, out.size() - written);
+            if (n <= 0) {
+                break;
+            }
+            written += n;
+        }
+        ::_exit(status);
+    }
+
+    ::close(fds[1]);
+    string out{};
+    char buffer[4096];
+    for (ssize_t n; (n = ::read(fds[0], buffer, sizeof(buffer))) > 0; ) {
+        out.append(buffer, n);
+    }
+    ::close(fds[0]);
+
+    int status = 0;
+    struct rusage usage{};
+    ::wait4(pid, &status, 0, &usage);
+
+    auto entry = out.empty()
+        ? json{{"error", "benchmark process died with status " + std::to_string(status)}}
+        : json::parse(out);
+    entry["config"] = config.filename().string();
+    entry["peak_rss_kb"] = usage.ru_maxrss;
+    return entry;
+}
+
+}
+
+int main(int argc, char const * argv[]) {
+    namespace po = boost::program_options;
+
+    po::options_description desc("Scheduler Adaptive benchmark options");
+    desc.add_options()
+        ("help", "produce help message")
+        ("tests-dir", po::value<std::string>()->default_value(SCHAD_TESTS_DIR),
+            "Directory whose source and experiment configs are benchmarked")
+        ("experiment", po::value<std::vector<std::string>>()->composing(),
+            "Additional experiment configuration to run end-to-end")
+        ("min-time", po::value<double>()->default_value(0.2),
+            "Minimum measured seconds per microbenchmark case")
+        ("num-runs", po::value<size_t>(),
+            "Override the number of runs of every experiment")
+        ("num-time-steps", po::value<size_t>(),
+            "Override the number of simulation steps of every experiment")
+        ("num-threads", po::value<size_t>()->default_value(1),
+            "Number of runs executed concurrently (0 for all cores)")
+        ("no-micro", "Skip the policy, learning and source microbenchmarks")
+        ("no-experiments", "Skip the end-to-end experiments")
+        ;
+
+    po::variables_map vm{};
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+
+    if (vm.count("help")) {
+        std::cout << desc << "\n";
+        return 0;
+    }
+
+    vector<schad::path> sources{}, experiments{};
+    auto const tests_dir = schad::path{vm["tests-dir"].as<std::string>()};
+    if (schad::filesystem::is_directory(tests_dir)) {
+        for (auto const& entry : schad::filesystem::directory_iterator{tests_dir}) {
+            if (entry.path().extension() != ".json") {
+                continue;
+            }
+            auto const cfg = read_json(entry.path());
+            if (!cfg.is_object()) {
+                continue;
+            }
+            if (cfg.count("infrastructure")) {
+                experiments.push_back(entry.path());
+            } else if (cfg.count("type")) {
+                sources.push_back(entry.path());
+            }
+        }
+    }
+    std::sort(begin(sources), end(sources));
+    std::sort(begin(experiments), end(experiments));
+    if (vm.count("experiment")) {
+        for (auto const& e : vm["experiment"].as<std::vector<std::string>>()) {
+            experiments.push_back(schad::filesystem::absolute(e));
+        }
+    }
+
+    auto const min_ns = vm["min-time"].as<double>() * 1e9;
+    auto overrides = ExperimentOverrides{{}, {}, vm["num-threads"].as<size_t>()};
+    if (vm.count("num-runs")) {
+        overrides.num_runs = vm["num-runs"].as<size_t>();
+    }
+    if (vm.count("num-time-steps")) {
+        overrides.num_time_steps = vm["num-time-steps"].as<size_t>();
+    }
+
+    schad::json json_output{{"version", 1}, {"min_time", vm["min-time"].as<double>()}};
+    if (!vm.count("no-experiments")) {
+        json_output["experiments"] = schad::json::array();
+        for (auto const& e : experiments) {
+            json_output["experiments"].push_back(bench_experiment(e, overrides));
+        }
+    }
+    if (!vm.count("no-micro")) {
+        json_output["policies"] = bench_policies(min_ns);
+        json_output["learning"] = bench_learning(min_ns);
+        json_output["sources"] = bench_sources(sources, min_ns);
+    }
+
+    std::cout << json_output << "\n";
+    return 0;
+}
@@ -5,6 +5,9 @@
 #include <schad/configs/source_config.h>
 #include <schad/configs/experiment_config.h>
 #include <schad/simulator/simulation.h>
+#include <schad/simulator/binary_stats.h>
+#include <schad/simulator/profile.h>
+#include <schad/traffic/replay_source.h>
 #include <schad/reward/weighted_throughput_reward.h>
 
 #include <iostream>
@@ -38,6 +41,14 @@ int main(int argc, char const * argv[]) {
             "Number of simulated policies")
         ("experiment-config", po::value<std::string>(),
             "Experiment JSON configuration (takes precedence)")
+        ("num-threads", po::value<size_t>()->default_value(0),
+            "Number of runs executed concurrently (0 for all cores)")
+        ("stats-output", po::value<std::string>(),
+            "Stream per-run statistics to a binary file instead of JSON")
+        ("stats-input", po::value<std::string>(),
+            "Print a binary statistics file as JSON and exit")
+        ("record-arrivals", po::value<std::string>(),
+            "Record the arrivals of every run for replay by a \"replay\" source")
         ;
 
     po::variables_map vm{};
@@ -48,6 +59,15 @@ int main(int argc, char const * argv[]) {
         return 0;
     }
 
+    if (vm.count("stats-input")) {
+        schad::BinaryStatsReader reader{vm["stats-input"].as<std::string>()};
+        schad::json json_output{};
+        json_output["result"] = reader.to_statistics();
+        json_output["aggregates"] = reader.aggregates();
+        std::cout << json_output;
+        return 0;
+    }
+
     auto experiment = schad::ExperimentParameters{};
     if (vm.count("experiment-config")) {
         experiment = schad::Loader::load_from_dir(
@@ -73,7 +93,48 @@ int main(int argc, char const * argv[]) {
 
     schad::json json_output{};
     json_output["experiment"] = experiment;
-    json_output["result"] = schad::run(experiment);
+
+    auto recorder = std::shared_ptr<schad::ArrivalRecorder>{};
+    if (vm.count("record-arrivals")) {
+        recorder = std::make_shared<schad::ArrivalRecorder>(
+            vm["record-arrivals"].as<std::string>(),
+            experiment.simulation_parameters().num_time_steps()
+        );
+        experiment.set_source(
+            schad::create_recording_source(experiment.source(), recorder)
+        );
+    }
+
+    auto num_runs = uint64_t{0};
+    if (vm.count("stats-output")) {
+        auto const path = vm["stats-output"].as<std::string>();
+        schad::BinaryStatsSink sink{
+            path, experiment.policies().size(), 
+            experiment.simulation_parameters().stat_batch_size()
+        };
+        schad::run(experiment, sink, vm["num-threads"].as<size_t>());
+        json_output["result"] = {{"stats_file", path}};
+        json_output["aggregates"] = sink.aggregates();
+        num_runs = sink.aggregates().num_runs();
+    } else {
+        auto const result = schad::run(
+            experiment, vm["num-threads"].as<size_t>()
+        );
+        json_output["result"] = result;
+        num_runs = result.rewards.size();
+    }
+
+    if (experiment.simulation_parameters().stopping()) {
+        json_output["num_runs"] = num_runs;
+    }
+
+    if (recorder) {
+        recorder->finish();
+    }
+
+    if (schad::profiling_enabled) {
+        json_output["profile"] = schad::collected_profile();
+    }
 
     std::cout << json_output;
     return 0;
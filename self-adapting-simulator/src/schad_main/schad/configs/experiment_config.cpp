@@ -8,19 +8,49 @@ namespace {
 
 using namespace schad;
 
+auto load_stopping_parameters(json const& conf) -> StoppingParameters {
+    auto const defaults = StoppingParameters{};
+    auto const result = StoppingParameters{}
+        .set_relative_half_width(conf.at("relative_half_width"))
+        .set_confidence(conf.value("confidence", defaults.confidence()))
+        .set_min_runs(conf.value("min_runs", defaults.min_runs()));
+    if (!(result.relative_half_width() > 0.0)) {
+        throw std::invalid_argument("stopping: relative_half_width must be positive");
+    }
+    if (!(result.confidence() > 0.0 && result.confidence() < 1.0)) {
+        throw std::invalid_argument("stopping: confidence must lie in (0, 1)");
+    }
+    if (result.min_runs() < 2) {
+        throw std::invalid_argument("stopping: min_runs must be at least 2");
+    }
+    return result;
+}
+
 auto load_simulation_parameters(json const& conf) -> SimulationParameters {
-    return SimulationParameters{}
+    auto result = SimulationParameters{}
         .set_num_time_steps(conf.at("num_time_steps"))
         .set_num_runs(conf.at("num_runs"))
         .set_stat_batch_size(conf.at("stat_batch_size"));
+    if (conf.count("stopping")) {
+        result.set_stopping(load_stopping_parameters(conf.at("stopping")));
+    }
+    return result;
 }
 
 auto save_simulation_parameters(SimulationParameters const& params) -> json {
-    return {
+    json result = {
         {"num_time_steps", params.num_time_steps()},
         {"num_runs", params.num_runs()},
         {"stat_batch_size", params.stat_batch_size()}
     };
+    if (auto const& stopping = params.stopping()) {
+        result["stopping"] = {
+            {"relative_half_width", stopping->relative_half_width()},
+            {"confidence", stopping->confidence()},
+            {"min_runs", stopping->min_runs()}
+        };
+    }
+    return result;
 }
 
 auto load_infrastructure_parameters(json const& conf) -> InfrastructureParameters {
@@ -3,16 +3,19 @@
 
 auto schad::load_policy(json const& cfg) -> shared_ptr<Policy> {
     auto const type = cfg.at("type").get<string>();
+    auto const backend = cfg.count("backend") 
+        ? pq_backend_from_name(cfg.at("backend").get<string>()) 
+        : PQBackend::SCAN;
     if (type == "value") {
-        return get_builtin_pq(BuiltInPQKind::VALUE);
+        return get_builtin_pq(BuiltInPQKind::VALUE, backend);
     } else if (type == "work") {
-        return get_builtin_pq(BuiltInPQKind::WORK);
+        return get_builtin_pq(BuiltInPQKind::WORK, backend);
     } else if (type == "value/work") {
-        return get_builtin_pq(BuiltInPQKind::VALUE_PER_WORK);
+        return get_builtin_pq(BuiltInPQKind::VALUE_PER_WORK, backend);
     } else if (type == "value/slack") {
-        return get_builtin_pq(BuiltInPQKind::VALUE_PER_SLACK);
+        return get_builtin_pq(BuiltInPQKind::VALUE_PER_SLACK, backend);
     } else if (type == "deadline") {
-        return get_builtin_pq(BuiltInPQKind::DEADLINE);
+        return get_builtin_pq(BuiltInPQKind::DEADLINE, backend);
     } else {
         throw unknown_policy_exception(type);
     }
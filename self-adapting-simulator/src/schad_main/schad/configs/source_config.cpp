@@ -4,6 +4,7 @@
 #include <schad/traffic/sequence_source.h>
 #include <schad/traffic/markov_source.h>
 #include <schad/traffic/null_source.h>
+#include <schad/traffic/replay_source.h>
 
 auto schad::load_source(json const& cfg, Loader const& loader) 
         -> unique_ptr<SourceFactory> {
@@ -20,6 +21,7 @@ auto schad::load_source(json const& cfg, Loader const& loader)
             ps_params.set_min_slack(params["slack"].at("min"));
             ps_params.set_max_slack(params["slack"].at("max"));
         }
+        ps_params.set_block_size(params.value("block_size", 0u));
 
         return create_poisson_source(std::move(ps_params));
     } else if (cfg.at("type") == "union") { 
@@ -56,6 +58,11 @@ auto schad::load_source(json const& cfg, Loader const& loader)
         return create_markov_source(std::move(markov_params));
     } else if (cfg.at("type") == "null") {
         return create_null_source();
+    } else if (cfg.at("type") == "replay") {
+        auto const& params = cfg.at("parameters");
+        return create_replay_source(
+            loader.resolve(params.at("path").get<string>()).string()
+        );
     } else {
         throw unknown_source_exception(cfg.at("type").get<string>());
     }
@@ -14,7 +14,7 @@ struct Infrastructure {
     virtual auto active_policy() const 
         -> tuple<PolicyInstance *, RewardFunction *> = 0;
     virtual auto simulated_policies() const 
-        -> vector<tuple<PolicyInstance *, RewardFunction *>> = 0;
+        -> vector<tuple<PolicyInstance *, RewardFunction *>> const& = 0;
     virtual void tick() = 0;
 
     Infrastructure() = default;
@@ -1,3 +1,4 @@
+#include <schad/simulator/profile.h>
 #include "infrastructure_impl.h"
 #include <iterator>
 
@@ -13,7 +14,7 @@ InfrastructureImpl::InfrastructureImpl(
       policies_{std::move(policies)}, learning_{std::move(learning)},
       rewards_pool_(params.num_simulated() + 1),
       stat_collector_{collector},
-      active_policy_idx_{0}, simulated_policies_idxs_{},
+      active_policy_idx_{0}, simulated_policies_idxs_{}, simulated_policies_{},
       since_last_batch_{0}  {
     std::generate(begin(rewards_pool_), end(rewards_pool_),
             [&reward] { return reward.clone(); });
@@ -21,6 +22,7 @@ InfrastructureImpl::InfrastructureImpl(
 }
 
 void InfrastructureImpl::reset_all_rewards() {
+    SCHAD_PROFILE_PHASE(Phase::REWARD);
     for (auto [p, r] : simulated_policies()) {
         r->reset(p->peek());
     }
@@ -38,22 +40,32 @@ void InfrastructureImpl::tick() {
 
 void InfrastructureImpl::finish_batch() {
     vector<optional<Reward>> rewards(policies_.size(), std::nullopt);
-    rewards[active_policy_idx_] = rewards_pool_.front()->get();
-    for (auto i = 0u; i < simulated_policies_idxs_.size(); ++i) {
-        rewards[simulated_policies_idxs_[i]] = rewards_pool_[i + 1]->get();
+    {
+        SCHAD_PROFILE_PHASE(Phase::REWARD);
+        rewards[active_policy_idx_] = rewards_pool_.front()->get();
+        for (auto i = 0u; i < simulated_policies_idxs_.size(); ++i) {
+            rewards[simulated_policies_idxs_[i]] = rewards_pool_[i + 1]->get();
+        }
+    }
+    {
+        SCHAD_PROFILE_PHASE(Phase::LEARNING_REPORT);
+        learning_->report_rewards(rewards);
     }
-
-    learning_->report_rewards(rewards);
     if (stat_collector_) {
+        SCHAD_PROFILE_PHASE(Phase::STATS);
         stat_collector_->append_step(
             active_policy_idx_, rewards_pool_.front()->get()
         );
     }
     simulated_policies_idxs_.clear();
+    simulated_policies_.clear();
 }
 
 void InfrastructureImpl::start_batch() {
-    auto const chosen = learning_->choose();
+    auto const chosen = [this] {
+        SCHAD_PROFILE_PHASE(Phase::LEARNING_CHOOSE);
+        return learning_->choose_top(1 + params_.num_simulated());
+    }();
     change_current(chosen.front());
 
     std::copy(
@@ -61,12 +73,18 @@ void InfrastructureImpl::start_batch() {
         begin(chosen) + (std::min(1 + params_.num_simulated(), chosen.size())),
         back_inserter(simulated_policies_idxs_)
     );
+    for (auto i = 0u; i < simulated_policies_idxs_.size(); ++i) {
+        simulated_policies_.emplace_back(
+            policies_[simulated_policies_idxs_[i]].get(), rewards_pool_[i + 1].get()
+        );
+    }
 
     since_last_batch_ = 0;
     reset_all_rewards();
 }
 
 void InfrastructureImpl::change_current(size_t active_policy_idx) {
+    SCHAD_PROFILE_PHASE(Phase::POLICY_SWITCH);
     if (active_policy_idx_ != active_policy_idx) {
         auto real_packets = policies_[active_policy_idx_]->take();
         auto simulated_packets = policies_[active_policy_idx]->take();
@@ -80,14 +98,8 @@ void InfrastructureImpl::change_current(size_t active_policy_idx) {
 }
 
 auto InfrastructureImpl::simulated_policies() const
-        -> vector<tuple<PolicyInstance *, RewardFunction *>> {
-    vector<tuple<PolicyInstance *, RewardFunction*>> result(simulated_policies_idxs_.size());
-    for (auto i = 0u; i < result.size(); ++i) {
-        result[i] = make_tuple(
-            policies_[simulated_policies_idxs_[i]].get(), rewards_pool_[i + 1].get()
-        );
-    }
-    return result;
+        -> vector<tuple<PolicyInstance *, RewardFunction *>> const& {
+    return simulated_policies_;
 }
 
 auto InfrastructureImpl::active_policy() const 
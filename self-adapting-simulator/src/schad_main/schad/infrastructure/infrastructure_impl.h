@@ -17,7 +17,7 @@ public:
 
     auto active_policy() const -> tuple<PolicyInstance *, RewardFunction *> override;
     auto simulated_policies() const 
-        -> vector<tuple<PolicyInstance *, RewardFunction *>> override;
+        -> vector<tuple<PolicyInstance *, RewardFunction *>> const& override;
 
     void tick() override;
 
@@ -38,6 +38,7 @@ private:
 
     size_t active_policy_idx_;
     vector<size_t> simulated_policies_idxs_;
+    vector<tuple<PolicyInstance *, RewardFunction *>> simulated_policies_;
     size_t since_last_batch_;
 };
 
@@ -36,14 +36,24 @@ struct PacketBuilder {
 
     auto build() -> unique_ptr<Packet>;
 
+    // Ids restart with every run, so they do not depend on which thread
+    // the run was scheduled on.
+    static void reset_ids() {
+        next_unused_id() = 0;
+    }
+
 private:
     PacketBuilder()
         : time_of_arrival_{}, initial_processing_{1}, value_{1.0} {
     }
 
+    static auto next_unused_id() -> uint32_t& {
+        thread_local uint32_t id = 0;
+        return id;
+    }
+
     static uint32_t next_id() {
-        static uint32_t next_unused_id = 0;
-        return next_unused_id++;
+        return next_unused_id()++;
     }
 
 private:
@@ -0,0 +1,79 @@
+#ifndef DETAIL_BUFFERED_PACKET_H
+#define DETAIL_BUFFERED_PACKET_H
+
+#include <schad/packet/packet.h>
+
+namespace schad::detail {
+
+// A packet in a policy's buffer. During PolicyInstance::admit_shared() an
+// arrival is only borrowed from the step's shared batch; the policy takes
+// a copy of it with keep() once it has survived the drop.
+class BufferedPacket {
+public:
+    BufferedPacket() : owned_{}, packet_{nullptr} {
+    }
+
+    explicit BufferedPacket(unique_ptr<Packet> p)
+        : owned_{std::move(p)}, packet_{owned_.get()} {
+    }
+
+    static auto borrow(Packet& p) -> BufferedPacket {
+        BufferedPacket result{};
+        result.packet_ = &p;
+        return result;
+    }
+
+    BufferedPacket(BufferedPacket&& other) noexcept
+        : owned_{std::move(other.owned_)}, packet_{other.packet_} {
+        other.packet_ = nullptr;
+    }
+
+    BufferedPacket& operator=(BufferedPacket&& other) noexcept {
+        owned_ = std::move(other.owned_);
+        packet_ = other.packet_;
+        other.packet_ = nullptr;
+        return *this;
+    }
+
+    auto get() const -> Packet * {
+        return packet_;
+    }
+
+    auto operator*() const -> Packet& {
+        return *packet_;
+    }
+
+    auto operator->() const -> Packet * {
+        return packet_;
+    }
+
+    explicit operator bool() const {
+        return packet_ != nullptr;
+    }
+
+    void keep() {
+        if (packet_ != nullptr && !owned_) {
+            owned_ = packet_->clone();
+            packet_ = owned_.get();
+        }
+    }
+
+    // Null for an arrival that was never kept.
+    auto release() -> unique_ptr<Packet> {
+        packet_ = nullptr;
+        return std::move(owned_);
+    }
+
+    void reset() {
+        owned_.reset();
+        packet_ = nullptr;
+    }
+
+private:
+    unique_ptr<Packet> owned_;
+    Packet * packet_;
+};
+
+}
+
+#endif // DETAIL_BUFFERED_PACKET_H
@@ -2,6 +2,9 @@
 #define DETAIL_PQ_H
 
 #include <schad/policy/policy.h>
+#include <schad/policy/pq_backend.h>
+#include <schad/policy/detail/buffered_packet.h>
+#include <schad/policy/detail/pq_heap.h>
 
 #include <set>
 #include <queue>
@@ -24,11 +27,21 @@ public:
         return drop();
     }
 
+    void admit_shared(vector<unique_ptr<Packet>> const& ps) override {
+        queue_.resize(queue_.size() + ps.size());
+        std::transform(begin(ps), end(ps), rbegin(queue_),
+                [] (auto const& p) { return detail::BufferedPacket::borrow(*p); });
+        drop();
+        for (auto& p : queue_) {
+            p.keep();
+        }
+    }
+
     auto transmit() -> unique_ptr<Packet> override {
         if (!queue_.empty() && is_ready(*queue_.front())) {
-            auto result = std::move(queue_.front());
+            auto result = queue_.front().release();
             queue_.pop_front();
-            return std::move(result);
+            return result;
         }
 
         return nullptr;
@@ -40,7 +53,7 @@ public:
         }
         auto best_it = std::min_element(
                 begin(queue_), end(queue_), create_comparator());
-        swap(queue_.front(), *best_it);
+        std::swap(queue_.front(), *best_it);
         return queue_.front().get();
     }
 
@@ -54,7 +67,8 @@ public:
 
     auto take() -> vector<unique_ptr<Packet>> override {
         vector<unique_ptr<Packet>> result(queue_.size());
-        std::move(begin(queue_), end(queue_), begin(result));
+        std::transform(begin(queue_), end(queue_), begin(result),
+                [] (auto& p) { return p.release(); });
         queue_.clear();
         return result;
     }
@@ -76,7 +90,8 @@ private:
 
     void admit(vector<unique_ptr<Packet>> ps) {
         queue_.resize(queue_.size() + ps.size());
-        std::move(begin(ps), end(ps), rbegin(queue_));
+        std::transform(begin(ps), end(ps), rbegin(queue_),
+                [] (auto& p) { return detail::BufferedPacket{std::move(p)}; });
     }
 
     auto drop() -> vector<unique_ptr<Packet>> {
@@ -90,7 +105,8 @@ private:
         }
 
         vector<unique_ptr<Packet>> result(std::distance(end_it, end(queue_)));
-        std::move(end_it, end(queue_), begin(result));
+        std::transform(end_it, end(queue_), begin(result),
+                [] (auto& p) { return p.release(); });
         queue_.erase(end_it, end(queue_));
         return result;
     }
@@ -100,18 +116,20 @@ private:
     size_t const buffer_size_;
 
     Priority prio_;
-    std::deque<unique_ptr<Packet>> queue_;
+    std::deque<detail::BufferedPacket> queue_;
 };
 
 }
 
 namespace schad::detail {
 
-template<class Priority> 
+struct NoHorizon {};
+
+template<class Priority, class Horizon = NoHorizon> 
 class PQPolicy : public Policy {
 public:
-    PQPolicy(std::string name, Priority prio) 
-        : name_{std::move(name)}, prio_{prio} {
+    PQPolicy(std::string name, Priority prio, PQBackend backend, Horizon horizon) 
+        : name_{std::move(name)}, prio_{prio}, backend_{backend}, horizon_{horizon} {
     }
 
     auto name() const -> string override {
@@ -129,27 +147,67 @@ public:
             auto const new_prio = [prio=prio_] (auto t, auto const& x) {
                     return make_tuple(is_expired(t, x) ? 1 : 0, prio(x), x.id());
             };
-            return make_unique<PQPolicyInstance<decltype(new_prio)>>(
-                world, buffer_size, new_prio
+            return instantiate(world, buffer_size, new_prio, 
+                [] (auto, auto const&, auto const&) { 
+                    return std::numeric_limits<uint32_t>::max();
+                }
             );
         } else {
             auto const new_prio = [prio=prio_] (auto t, auto const& x) {
                 return make_tuple(is_expired(t, x) ? 1 : 0, prio(t, x), x.id());
             };
-            return make_unique<PQPolicyInstance<decltype(new_prio)>>(
-                world, buffer_size, new_prio
+            return instantiate(world, buffer_size, new_prio, 
+                [horizon=horizon_] (auto t, auto const& a, auto const& b) -> uint32_t {
+                    if (is_expired(t, a) || is_expired(t, b)) {
+                        return t;
+                    }
+                    if constexpr (std::is_same_v<Horizon, NoHorizon>) {
+                        return t;
+                    } else {
+                        return horizon(t, a, b);
+                    }
+                }
             );
         }     
     }
 
-
     void to_json(json& j) const override {
         j = {{"type", name()}};
+        if (backend_ != PQBackend::SCAN) {
+            j["backend"] = pq_backend_name(backend_);
+        }
+    }
+
+private:
+    template<class NewPriority, class NewHorizon>
+    auto instantiate(World * world, size_t buffer_size, 
+                     NewPriority prio, NewHorizon horizon) const
+            -> unique_ptr<PolicyInstance> {
+        if (backend_ == PQBackend::HEAP) {
+            auto const expiry_horizon = [horizon] (auto t, auto const& a, auto const& b) {
+                auto result = horizon(t, a, b);
+                for (auto const* x : {&a, &b}) {
+                    if (x->slack().has_value() && !is_expired(t, *x)) {
+                        result = std::min(result, deadline(*x) - 1);
+                    }
+                }
+                return result;
+            };
+            return make_unique<HeapPQPolicyInstance<NewPriority, decltype(expiry_horizon)>>(
+                world, buffer_size, prio, expiry_horizon
+            );
+        } else {
+            return make_unique<PQPolicyInstance<NewPriority>>(
+                world, buffer_size, prio
+            );
+        }
     }
 
 private:
     string const name_;
     Priority prio_;
+    PQBackend const backend_;
+    Horizon horizon_;
 };
 
 }
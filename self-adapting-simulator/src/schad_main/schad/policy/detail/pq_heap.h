@@ -0,0 +1,257 @@
+#ifndef DETAIL_PQ_HEAP_H
+#define DETAIL_PQ_HEAP_H
+
+#include <schad/policy/policy.h>
+#include <schad/policy/detail/buffered_packet.h>
+
+#include <queue>
+#include <limits>
+#include <numeric>
+#include <functional>
+
+namespace {
+
+using namespace schad;
+
+template<class Priority, class Horizon> 
+class HeapPQPolicyInstance : public PolicyInstance {
+    static constexpr auto const npos = std::numeric_limits<size_t>::max();
+    static constexpr auto const always = std::numeric_limits<int64_t>::max();
+    static constexpr auto const dirty = int64_t{-1};
+
+    using ExpiryEntry = tuple<uint32_t, size_t, uint64_t>;
+
+public:
+    HeapPQPolicyInstance(World * world, size_t buffer_size, 
+                         Priority prio, Horizon horizon) 
+        : world_{world}, buffer_size_{buffer_size}, 
+          prio_{prio}, horizon_{horizon}, capacity_{0}, 
+          slots_{}, stamps_{}, free_slots_{}, 
+          best_{}, worst_{}, valid_until_{}, 
+          expiry_{}, num_packets_{0}, selected_{npos}, admitted_{} {
+        grow(buffer_size + 1);
+    }
+
+    auto admit_n_drop(vector<unique_ptr<Packet>> ps)
+            -> vector<unique_ptr<Packet>> override {
+        for (auto& p : ps) {
+            insert(detail::BufferedPacket{std::move(p)});
+        }
+        return drop();
+    }
+
+    void admit_shared(vector<unique_ptr<Packet>> const& ps) override {
+        admitted_.clear();
+        for (auto const& p : ps) {
+            admitted_.push_back(insert(detail::BufferedPacket::borrow(*p)));
+        }
+        drop();
+        for (auto slot : admitted_) {
+            slots_[slot].keep();
+        }
+    }
+
+    auto transmit() -> unique_ptr<Packet> override {
+        if (selected_ != npos && is_ready(*slots_[selected_])) {
+            return erase(selected_);
+        }
+        return nullptr;
+    }
+
+    auto select_for_processing() -> Packet * override {
+        if (num_packets_ == 0) {
+            return nullptr;
+        }
+        refresh(1, world_->current_time());
+        selected_ = best_[1];
+        return slots_[selected_].get();
+    }
+
+    void processing_finished(Packet * packet) override {
+        assert(slots_[selected_].get() == packet);
+        touch(selected_);
+    }
+
+    auto num_packets_in_buffer() const noexcept -> size_t override  {
+        return num_packets_;
+    }
+
+    auto take() -> vector<unique_ptr<Packet>> override {
+        vector<unique_ptr<Packet>> result{};
+        for (auto& p : slots_) {
+            if (p) {
+                result.emplace_back(p.release());
+            }
+        }
+        reset();
+        return result;
+    }
+
+    auto peek() const -> vector<Packet const *> override {
+        vector<Packet const *> result{};
+        for (auto const& p : slots_) {
+            if (p) {
+                result.push_back(p.get());
+            }
+        }
+        return result;
+    }
+
+private:
+    auto insert(detail::BufferedPacket p) -> size_t {
+        if (free_slots_.empty()) {
+            grow(2 * capacity_);
+        }
+        auto const slot = free_slots_.back();
+        free_slots_.pop_back();
+
+        slots_[slot] = std::move(p);
+        stamps_[slot]++;
+        num_packets_++;
+        touch(slot);
+
+        if (slots_[slot]->slack().has_value()) {
+            expiry_.emplace(deadline(*slots_[slot]), slot, stamps_[slot]);
+        }
+        return slot;
+    }
+
+    auto erase(size_t slot) -> unique_ptr<Packet> {
+        auto result = slots_[slot].release();
+        free_slots_.push_back(slot);
+        num_packets_--;
+        touch(slot);
+
+        if (slot == selected_) {
+            selected_ = npos;
+        }
+        return result;
+    }
+
+    auto drop() -> vector<unique_ptr<Packet>> {
+        auto const t = world_->current_time();
+        vector<unique_ptr<Packet>> result{};
+
+        while (!expiry_.empty() && std::get<0>(expiry_.top()) <= t) {
+            auto const slot = std::get<1>(expiry_.top());
+            auto const stamp = std::get<2>(expiry_.top());
+            expiry_.pop();
+            if (stamps_[slot] != stamp || !slots_[slot]) {
+                continue;
+            }
+            if (is_expired(t, *slots_[slot])) {
+                result.emplace_back(erase(slot));
+            } else {
+                expiry_.emplace(deadline(*slots_[slot]), slot, stamp);
+            }
+        }
+
+        while (num_packets_ > buffer_size_) {
+            refresh(1, t);
+            result.emplace_back(erase(worst_[1]));
+        }
+        return result;
+    }
+
+    void touch(size_t slot) {
+        auto const leaf = capacity_ + slot;
+        best_[leaf] = worst_[leaf] = slots_[slot] ? slot : npos;
+        for (auto node = leaf / 2; node > 0 && valid_until_[node] != dirty; node /= 2) {
+            valid_until_[node] = dirty;
+        }
+    }
+
+    void refresh(size_t node, uint32_t t) {
+        if (valid_until_[node] >= t) {
+            return;
+        }
+        auto const left = 2 * node;
+        auto const right = left + 1;
+        refresh(left, t);
+        refresh(right, t);
+
+        auto const [best, best_until] = compete(best_[left], best_[right], t, true);
+        auto const [worst, worst_until] = compete(worst_[left], worst_[right], t, false);
+        best_[node] = best;
+        worst_[node] = worst;
+        valid_until_[node] = std::min({
+            best_until, worst_until, valid_until_[left], valid_until_[right]
+        });
+    }
+
+    auto compete(size_t a, size_t b, uint32_t t, bool smaller_wins) const
+            -> pair<size_t, int64_t> {
+        if (a == npos || b == npos) {
+            return make_pair(a == npos ? b : a, always);
+        }
+        auto const a_smaller = prio_(t, *slots_[a]) < prio_(t, *slots_[b]);
+        return make_pair(
+            a_smaller == smaller_wins ? a : b, 
+            int64_t{horizon_(t, *slots_[a], *slots_[b])}
+        );
+    }
+
+    void grow(size_t min_capacity) {
+        auto capacity = std::max(capacity_, size_t{1});
+        while (capacity < min_capacity) {
+            capacity *= 2;
+        }
+
+        slots_.resize(capacity);
+        stamps_.resize(capacity, 0);
+        for (auto slot = capacity; slot > capacity_; --slot) {
+            free_slots_.push_back(slot - 1);
+        }
+        capacity_ = capacity;
+        rebuild();
+    }
+
+    void reset() {
+        for (auto& p : slots_) {
+            p.reset();
+        }
+        free_slots_.resize(capacity_);
+        std::iota(rbegin(free_slots_), rend(free_slots_), 0);
+        expiry_ = decltype(expiry_){};
+        num_packets_ = 0;
+        selected_ = npos;
+        rebuild();
+    }
+
+    void rebuild() {
+        best_.assign(2 * capacity_, npos);
+        worst_.assign(2 * capacity_, npos);
+        valid_until_.assign(2 * capacity_, always);
+        std::fill(begin(valid_until_), begin(valid_until_) + capacity_, dirty);
+        for (auto slot = 0u; slot < capacity_; ++slot) {
+            if (slots_[slot]) {
+                best_[capacity_ + slot] = worst_[capacity_ + slot] = slot;
+            }
+        }
+    }
+
+private:
+    World * const world_;
+    size_t const buffer_size_;
+
+    Priority prio_;
+    Horizon horizon_;
+
+    size_t capacity_;
+    vector<detail::BufferedPacket> slots_;
+    vector<uint64_t> stamps_;
+    vector<size_t> free_slots_;
+
+    vector<size_t> best_;
+    vector<size_t> worst_;
+    vector<int64_t> valid_until_;
+
+    std::priority_queue<ExpiryEntry, vector<ExpiryEntry>, std::greater<>> expiry_;
+    size_t num_packets_;
+    size_t selected_;
+    vector<size_t> admitted_;
+};
+
+}
+
+#endif // DETAIL_PQ_HEAP_H
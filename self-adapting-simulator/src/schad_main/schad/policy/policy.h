@@ -8,6 +8,9 @@ namespace schad {
 
 struct PolicyInstance {
     virtual auto admit_n_drop(vector<unique_ptr<Packet>> p) -> vector<unique_ptr<Packet>> = 0;
+    // Admits a batch of arrivals that other policies see as well, copying
+    // only the packets that are not dropped on admission.
+    virtual void admit_shared(vector<unique_ptr<Packet>> const& p) = 0;
     virtual auto select_for_processing() -> Packet * = 0;
     virtual void processing_finished(Packet * packet) = 0;
     virtual auto transmit() -> unique_ptr<Packet> = 0;
@@ -0,0 +1,41 @@
+#ifndef PQ_BACKEND_H
+#define PQ_BACKEND_H
+
+#include <schad/common.h>
+#include <stdexcept>
+
+namespace schad {
+
+enum class PQBackend {
+    SCAN, HEAP
+};
+
+struct unknown_pq_backend_exception : std::invalid_argument {
+    unknown_pq_backend_exception(string const& backend_name)
+        : invalid_argument("unknown pq backend: " + backend_name) {
+    }
+};
+
+inline auto pq_backend_name(PQBackend backend) -> string {
+    switch (backend) {
+        case PQBackend::SCAN:
+            return "scan";
+        case PQBackend::HEAP:
+            return "heap";
+    }
+    return "";
+}
+
+inline auto pq_backend_from_name(string const& name) -> PQBackend {
+    if (name == "scan") {
+        return PQBackend::SCAN;
+    } else if (name == "heap") {
+        return PQBackend::HEAP;
+    } else {
+        throw unknown_pq_backend_exception(name);
+    }
+}
+
+}
+
+#endif // PQ_BACKEND_H
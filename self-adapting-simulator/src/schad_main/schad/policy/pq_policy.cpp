@@ -1,40 +1,80 @@
 #include <schad/policy/pq_policy_gen.h>
 #include "pq_policy.h"
 
-auto schad::get_builtin_pq(BuiltInPQKind kind) -> shared_ptr<Policy>const & {
+#include <cmath>
+
+namespace {
+
+using namespace schad;
+
+template<class Priority, class... Horizon>
+auto cached_pq(string const& name, PQBackend backend, Priority prio, Horizon... horizon) 
+        -> shared_ptr<Policy> const& {
+    static shared_ptr<Policy> const scan = create_pq_policy(
+        name, prio, PQBackend::SCAN, horizon...);
+    static shared_ptr<Policy> const heap = create_pq_policy(
+        name, prio, PQBackend::HEAP, horizon...);
+    return backend == PQBackend::HEAP ? heap : scan;
+}
+
+auto value_per_slack_horizon(uint32_t t, Packet const& a, Packet const& b) -> uint32_t {
+    auto constexpr const margin = 1e-9;
+    auto const da = double(deadline(a));
+    auto const db = double(deadline(b));
+
+    auto const cross = a.value() * db - b.value() * da;
+    auto const slope = a.value() - b.value();
+    auto const scale = a.value() * db + b.value() * da;
+    auto const scale_slope = a.value() + b.value();
+
+    auto const sign = (cross - slope * t) > 0 ? 1.0 : -1.0;
+    auto const gap = sign * cross - margin * scale;
+    auto const gap_slope = sign * slope - margin * scale_slope;
+
+    if (gap - gap_slope * t <= 0) {
+        return t;
+    }
+    if (gap_slope <= 0) {
+        return std::numeric_limits<uint32_t>::max();
+    }
+    auto const until = std::floor(gap / gap_slope) - 1;
+    if (until <= t) {
+        return t;
+    }
+    return uint32_t(std::min(until, double(std::numeric_limits<uint32_t>::max())));
+}
+
+}
+
+auto schad::get_builtin_pq(BuiltInPQKind kind, PQBackend backend) 
+        -> shared_ptr<Policy> const& {
     switch (kind) {
         case BuiltInPQKind::VALUE: {
-            static shared_ptr<Policy> p = create_pq_policy("value", [] (auto const& x) { 
+            return cached_pq("value", backend, [] (auto const& x) { 
                  return -x.value();
             });
-            return p;
         } break;
         case BuiltInPQKind::WORK: {
-            static shared_ptr<Policy> p = schad::create_pq_policy("work", [] (auto const& x) { 
+            return cached_pq("work", backend, [] (auto const& x) { 
                 return x.remaining_processing();
             });
-            return p;
         } break;
         case BuiltInPQKind::VALUE_PER_WORK: {
-            static shared_ptr<Policy> p = schad::create_pq_policy("value/work", [] (auto const& x) { 
+            return cached_pq("value/work", backend, [] (auto const& x) { 
                 return -double(x.value()) / (double(x.remaining_processing()) + 0.0001);
             });
-            return p;
         } break;
         case BuiltInPQKind::DEADLINE: {
-            static shared_ptr<Policy> p = schad::create_pq_policy("deadline", [] (auto const& x) { 
+            return cached_pq("deadline", backend, [] (auto const& x) { 
                 return deadline(x);
             });
-            return p;
         } break;
         case BuiltInPQKind::VALUE_PER_SLACK: {
-            static shared_ptr<Policy> p = schad::create_pq_policy("value/slack", [] (auto const t, auto const& x) { 
+            return cached_pq("value/slack", backend, [] (auto const t, auto const& x) { 
                 return -x.value() / double(deadline(x) - t);
-            });
-            return p;
+            }, value_per_slack_horizon);
         } break;
         default: 
             exit(1);
     };
 }
-
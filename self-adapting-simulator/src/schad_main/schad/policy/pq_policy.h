@@ -2,6 +2,7 @@
 #define PQ_POLICY_H
 
 #include <schad/policy/policy.h>
+#include <schad/policy/pq_backend.h>
 
 namespace schad {
 
@@ -9,7 +10,8 @@ enum class BuiltInPQKind {
     WORK, VALUE, VALUE_PER_WORK, VALUE_PER_SLACK, DEADLINE
 };
 
-auto get_builtin_pq(BuiltInPQKind kind) -> shared_ptr<Policy> const&;
+auto get_builtin_pq(BuiltInPQKind kind, PQBackend backend = PQBackend::SCAN) 
+    -> shared_ptr<Policy> const&;
 
 
 }
@@ -5,9 +5,13 @@
 
 namespace schad {
 
-template<class Priority >
-auto create_pq_policy(string const& name, Priority prio) -> unique_ptr<Policy> {
-    return make_unique<detail::PQPolicy<Priority>>(name, prio);
+template<class Priority, class Horizon = detail::NoHorizon>
+auto create_pq_policy(string const& name, Priority prio, 
+        PQBackend backend = PQBackend::SCAN, Horizon horizon = {}) 
+        -> unique_ptr<Policy> {
+    return make_unique<detail::PQPolicy<Priority, Horizon>>(
+        name, prio, backend, horizon
+    );
 }
 
 }
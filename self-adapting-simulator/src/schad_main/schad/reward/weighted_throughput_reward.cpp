@@ -1,9 +1,11 @@
+#include <schad/reward/reward_function_helper.h>
 #include "weighted_throughput_reward.h"
 
 namespace {
 using namespace schad;
 
-class WeightedThroughputReward : public RewardFunction {
+class WeightedThroughputReward final 
+    : public RewardFunctionHelper<WeightedThroughputReward> {
 public:
     WeightedThroughputReward() 
         : total_arrival_{}, total_transmission_{} {
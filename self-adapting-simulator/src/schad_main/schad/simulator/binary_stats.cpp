@@ -0,0 +1,245 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "binary_stats.h"
+
+namespace schad {
+
+namespace {
+
+auto padded(uint64_t size) -> uint64_t {
+    return (size + 7) / 8 * 8;
+}
+
+auto run_block_size(BinaryStatsHeader const& header) -> uint64_t {
+    return padded(
+        2 * header.num_batches * sizeof(double) +
+        header.num_arms * header.num_batches * sizeof(uint32_t)
+    );
+}
+
+auto aggregates_size(BinaryStatsHeader const& header) -> uint64_t {
+    auto const nb = header.num_batches;
+    auto const nq = header.num_quantiles;
+    return sizeof(double) * (nq + 2 * (2 + nq) * nb + header.num_arms * nb);
+}
+
+}
+
+BinaryStatsSink::BinaryStatsSink(
+        string path, size_t num_arms, uint64_t stat_batch_size)
+    : StatsSink{num_arms}, path_{std::move(path)},
+      out_{path_, std::ios::binary | std::ios::trunc}, header_{},
+      finished_{false} {
+    if (!out_) {
+        throw stats_file_exception(path_, "cannot open for writing");
+    }
+    if (stat_batch_size > std::numeric_limits<uint32_t>::max()) {
+        throw stats_file_exception(path_, "stat batch size exceeds 32 bits");
+    }
+
+    std::memcpy(header_.magic, BinaryStatsHeader::magic_value, sizeof(header_.magic));
+    header_.version = BinaryStatsHeader::version_value;
+    header_.num_quantiles = OnlineStatistics::quantile_probs.size();
+    header_.num_arms = num_arms;
+    header_.stat_batch_size = stat_batch_size;
+    out_.write(reinterpret_cast<char const *>(&header_), sizeof(header_));
+}
+
+template<class T>
+void BinaryStatsSink::write_column(vector<T> const& values) {
+    out_.write(
+        reinterpret_cast<char const *>(values.data()),
+        values.size() * sizeof(T)
+    );
+}
+
+void BinaryStatsSink::write(RunStatistics run) {
+    if (header_.num_runs == 0) {
+        header_.num_batches = run.rewards.size();
+    } else if (run.rewards.size() != header_.num_batches) {
+        throw stats_file_exception(path_, "runs differ in number of batches");
+    }
+
+    write_column(run.rewards);
+    write_column(run.totals);
+    vector<uint32_t> counts(header_.num_batches);
+    for (auto const& arm : run.arms) {
+        std::copy(begin(arm), end(arm), begin(counts));
+        write_column(counts);
+    }
+    auto const written =
+        2 * header_.num_batches * sizeof(double) +
+        header_.num_arms * header_.num_batches * sizeof(uint32_t);
+    write_column(vector<char>(padded(written) - written, 0));
+
+    header_.num_runs++;
+}
+
+void BinaryStatsSink::finish() {
+    StatsSink::finish();
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+
+    auto const& stats = aggregates();
+    auto const series_column = [&] (OnlineStatistics::Series const& series) {
+        vector<double> mean{}, variance{};
+        for (auto const& m : series.moments) {
+            mean.push_back(m.mean());
+            variance.push_back(m.variance());
+        }
+        write_column(mean);
+        write_column(variance);
+        for (auto k = 0u; k < header_.num_quantiles; ++k) {
+            vector<double> values{};
+            for (auto const& qs : series.quantiles) {
+                values.push_back(qs[k].value());
+            }
+            write_column(values);
+        }
+    };
+
+    header_.aggregates_offset = sizeof(header_) +
+        header_.num_runs * run_block_size(header_);
+    write_column(vector<double>(
+        begin(OnlineStatistics::quantile_probs),
+        end(OnlineStatistics::quantile_probs)
+    ));
+    series_column(stats.rewards());
+    series_column(stats.totals());
+    for (auto const& arm : stats.arms()) {
+        vector<double> mean{};
+        for (auto const& m : arm) {
+            mean.push_back(m.mean());
+        }
+        write_column(mean);
+    }
+
+    out_.seekp(0);
+    out_.write(reinterpret_cast<char const *>(&header_), sizeof(header_));
+    out_.close();
+    if (!out_) {
+        throw stats_file_exception(path_, "write failed");
+    }
+}
+
+BinaryStatsReader::BinaryStatsReader(string path)
+    : path_{std::move(path)}, data_{nullptr}, size_{0} {
+    auto const fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw stats_file_exception(path_, "cannot open for reading");
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(BinaryStatsHeader)) {
+        ::close(fd);
+        throw stats_file_exception(path_, "truncated header");
+    }
+    size_ = st.st_size;
+
+    auto const mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw stats_file_exception(path_, "mmap failed");
+    }
+    data_ = static_cast<unsigned char const *>(mapped);
+
+    auto const& h = header();
+    auto const valid =
+        std::memcmp(h.magic, BinaryStatsHeader::magic_value, sizeof(h.magic)) == 0 &&
+        h.version == BinaryStatsHeader::version_value &&
+        h.aggregates_offset == sizeof(h) + h.num_runs * run_block_size(h) &&
+        h.aggregates_offset + aggregates_size(h) <= size_;
+    if (!valid) {
+        ::munmap(const_cast<unsigned char *>(data_), size_);
+        throw stats_file_exception(path_, "not a complete statistics file");
+    }
+}
+
+BinaryStatsReader::~BinaryStatsReader() {
+    ::munmap(const_cast<unsigned char *>(data_), size_);
+}
+
+auto BinaryStatsReader::run_block(uint64_t run_idx) const
+        -> unsigned char const * {
+    assert(run_idx < num_runs());
+    return data_ + sizeof(BinaryStatsHeader) +
+        run_idx * run_block_size(header());
+}
+
+auto BinaryStatsReader::rewards(uint64_t run_idx) const -> double const * {
+    return reinterpret_cast<double const *>(run_block(run_idx));
+}
+
+auto BinaryStatsReader::totals(uint64_t run_idx) const -> double const * {
+    return rewards(run_idx) + num_batches();
+}
+
+auto BinaryStatsReader::arms(uint64_t run_idx, size_t arm_idx) const
+        -> uint32_t const * {
+    assert(arm_idx < num_arms());
+    return reinterpret_cast<uint32_t const *>(totals(run_idx) + num_batches())
+        + arm_idx * num_batches();
+}
+
+auto BinaryStatsReader::to_statistics() const -> Statistics {
+    auto const nb = num_batches();
+    vector<vector<double>> rewards(num_runs());
+    vector<vector<double>> totals(num_runs());
+    vector<vector<vector<size_t>>> arms(num_runs());
+    for (auto r = 0u; r < num_runs(); ++r) {
+        rewards[r].assign(this->rewards(r), this->rewards(r) + nb);
+        totals[r].assign(this->totals(r), this->totals(r) + nb);
+        for (auto a = 0u; a < num_arms(); ++a) {
+            arms[r].emplace_back(this->arms(r, a), this->arms(r, a) + nb);
+        }
+    }
+    return Statistics{std::move(rewards), std::move(totals), std::move(arms)};
+}
+
+auto BinaryStatsReader::aggregates() const -> json {
+    auto const nb = num_batches();
+    auto const nq = header().num_quantiles;
+    auto column = reinterpret_cast<double const *>(
+        data_ + header().aggregates_offset
+    );
+    vector<double> const probs(column, column + nq);
+    column += nq;
+
+    auto const next_column = [&] {
+        vector<double> values(column, column + nb);
+        column += nb;
+        return values;
+    };
+    auto const series = [&] {
+        json result = {{"mean", next_column()}, {"variance", next_column()}};
+        json quantiles = json::object();
+        for (auto p : probs) {
+            quantiles["p" + std::to_string(std::lround(100 * p))] = next_column();
+        }
+        result["quantiles"] = quantiles;
+        return result;
+    };
+
+    auto rewards = series();
+    auto totals = series();
+    vector<vector<double>> arms_mean{};
+    for (auto a = 0u; a < num_arms(); ++a) {
+        arms_mean.push_back(next_column());
+    }
+
+    return {{"num_runs", num_runs()},
+            {"rewards", rewards},
+            {"totals", totals},
+            {"arms_mean", arms_mean}};
+}
+
+}
@@ -0,0 +1,101 @@
+#ifndef BINARY_STATS_H
+#define BINARY_STATS_H
+
+#include <schad/simulator/stats_sink.h>
+#include <schad/common.h>
+
+#include <fstream>
+#include <stdexcept>
+
+namespace schad {
+
+struct stats_file_exception : std::runtime_error {
+    stats_file_exception(string const& path, string const& reason)
+        : std::runtime_error(path + ": " + reason) {
+    }
+};
+
+struct BinaryStatsHeader {
+    static constexpr char magic_value[8] = "SCHADST";
+    static constexpr uint32_t version_value = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t num_quantiles;
+    uint64_t num_arms;
+    uint64_t stat_batch_size;
+    uint64_t num_batches;
+    uint64_t num_runs;
+    uint64_t aggregates_offset;
+    uint64_t reserved;
+};
+
+static_assert(sizeof(BinaryStatsHeader) == 64);
+
+class BinaryStatsSink : public StatsSink {
+public:
+    BinaryStatsSink(string path, size_t num_arms, uint64_t stat_batch_size);
+
+    void finish() override;
+
+protected:
+    void write(RunStatistics run) override;
+
+private:
+    template<class T>
+    void write_column(vector<T> const& values);
+
+private:
+    string const path_;
+    std::ofstream out_;
+    BinaryStatsHeader header_;
+    bool finished_;
+};
+
+class BinaryStatsReader {
+public:
+    explicit BinaryStatsReader(string path);
+    ~BinaryStatsReader();
+
+    BinaryStatsReader(BinaryStatsReader const&) = delete;
+    BinaryStatsReader& operator=(BinaryStatsReader const&) = delete;
+
+    auto num_runs() const {
+        return header().num_runs;
+    }
+
+    auto num_batches() const {
+        return header().num_batches;
+    }
+
+    auto num_arms() const {
+        return header().num_arms;
+    }
+
+    auto stat_batch_size() const {
+        return header().stat_batch_size;
+    }
+
+    auto rewards(uint64_t run_idx) const -> double const *;
+    auto totals(uint64_t run_idx) const -> double const *;
+    auto arms(uint64_t run_idx, size_t arm_idx) const -> uint32_t const *;
+
+    auto to_statistics() const -> Statistics;
+    auto aggregates() const -> json;
+
+private:
+    auto header() const -> BinaryStatsHeader const& {
+        return *reinterpret_cast<BinaryStatsHeader const *>(data_);
+    }
+
+    auto run_block(uint64_t run_idx) const -> unsigned char const *;
+
+private:
+    string const path_;
+    unsigned char const * data_;
+    size_t size_;
+};
+
+}
+
+#endif // BINARY_STATS_H
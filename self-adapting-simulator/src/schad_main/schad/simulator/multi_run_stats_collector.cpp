@@ -3,25 +3,25 @@
 namespace schad {
 
 MultiRunStatsCollector::MultiRunStatsCollector(
-        size_t num_arms, uint64_t batch_size) 
-    : num_arms_{num_arms}, batch_size_{batch_size}, batch_idx_{0},
-      rewards_{}, totals_{}, arms_{} {
+        size_t num_arms, uint64_t batch_size, StatsSink& sink) 
+    : num_arms_{num_arms}, batch_size_{batch_size}, sink_{sink}, 
+      batch_idx_{0}, run_idx_{0}, run_{} {
 }
 
 void MultiRunStatsCollector::append_step(size_t arm_idx, Reward reward) {
-    assert(!rewards_.empty() && !arms_.empty());
+    assert(run_.arms.size() == num_arms_);
 
     if (batch_idx_ == 0) {
-        rewards_.back().push_back(0.0);
-        totals_.back().push_back(0.0);
-        for (auto& arm : arms_.back()) {
+        run_.rewards.push_back(0.0);
+        run_.totals.push_back(0.0);
+        for (auto& arm : run_.arms) {
             arm.push_back(0);
         }
     }
 
-    rewards_.back().back() += reward.value();
-    totals_.back().back() += reward.total().value_or(0.0);
-    arms_.back()[arm_idx].back()++;
+    run_.rewards.back() += reward.value();
+    run_.totals.back() += reward.total().value_or(0.0);
+    run_.arms[arm_idx].back()++;
 
     batch_idx_++;
     if (batch_idx_ == batch_size_) {
@@ -29,15 +29,15 @@ void MultiRunStatsCollector::append_step(size_t arm_idx, Reward reward) {
     }
 }
 
-void MultiRunStatsCollector::next_run() {
-    rewards_.push_back({});
-    totals_.push_back({});
-    arms_.push_back(vector<vector<size_t>>(num_arms_));
+void MultiRunStatsCollector::next_run(uint64_t run_idx) {
+    run_idx_ = run_idx;
+    run_ = RunStatistics{{}, {}, vector<vector<size_t>>(num_arms_)};
     batch_idx_ = 0;
 }
 
-auto MultiRunStatsCollector::get_statistics() const -> Statistics {
-    return Statistics{rewards_, totals_, arms_};
+void MultiRunStatsCollector::finish_run() {
+    sink_.consume(run_idx_, std::move(run_));
+    run_ = RunStatistics{};
 }
 
 }
@@ -0,0 +1,169 @@
+#include <cmath>
+#include <limits>
+
+#include "online_statistics.h"
+
+namespace schad {
+
+P2Quantile::P2Quantile(double p)
+    : p_{p}, count_{0}, heights_{}, positions_{1, 2, 3, 4, 5},
+      desired_{1, 1 + 2 * p, 1 + 4 * p, 3 + 2 * p, 5},
+      increments_{0, p / 2, p, (1 + p) / 2, 1} {
+}
+
+void P2Quantile::add(double x) {
+    if (count_ < heights_.size()) {
+        heights_[count_++] = x;
+        if (count_ == heights_.size()) {
+            std::sort(begin(heights_), end(heights_));
+        }
+        return;
+    }
+    count_++;
+
+    size_t k = 0;
+    if (x < heights_[0]) {
+        heights_[0] = x;
+    } else if (x >= heights_[4]) {
+        heights_[4] = x;
+        k = 3;
+    } else {
+        while (x >= heights_[k + 1]) {
+            k++;
+        }
+    }
+
+    for (auto i = k + 1; i < positions_.size(); ++i) {
+        positions_[i]++;
+    }
+    for (auto i = 0u; i < desired_.size(); ++i) {
+        desired_[i] += increments_[i];
+    }
+
+    for (auto i = 1u; i < 4; ++i) {
+        auto const d = desired_[i] - positions_[i];
+        if ((d >= 1 && positions_[i + 1] - positions_[i] > 1) ||
+                (d <= -1 && positions_[i - 1] - positions_[i] < -1)) {
+            auto const step = d >= 0 ? 1.0 : -1.0;
+            auto const candidate = parabolic(i, step);
+            if (heights_[i - 1] < candidate && candidate < heights_[i + 1]) {
+                heights_[i] = candidate;
+            } else {
+                heights_[i] = linear(i, step);
+            }
+            positions_[i] += step;
+        }
+    }
+}
+
+auto P2Quantile::parabolic(size_t i, double d) const -> double {
+    auto const& q = heights_;
+    auto const& n = positions_;
+    return q[i] + d / (n[i + 1] - n[i - 1]) * (
+        (n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+        (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1])
+    );
+}
+
+auto P2Quantile::linear(size_t i, double d) const -> double {
+    auto const j = d > 0 ? i + 1 : i - 1;
+    return heights_[i] + d * (heights_[j] - heights_[i])
+        / (positions_[j] - positions_[i]);
+}
+
+auto P2Quantile::value() const -> double {
+    if (count_ == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (count_ < heights_.size()) {
+        auto sorted = heights_;
+        std::sort(begin(sorted), begin(sorted) + count_);
+        auto const idx = size_t(std::lround(p_ * (count_ - 1)));
+        return sorted[idx];
+    }
+    return heights_[2];
+}
+
+OnlineStatistics::OnlineStatistics(size_t num_arms)
+    : num_runs_{0}, rewards_{}, totals_{}, arms_(num_arms) {
+}
+
+void OnlineStatistics::resize(size_t num_batches) {
+    for (auto series : {&rewards_, &totals_}) {
+        series->moments.resize(num_batches);
+        while (series->quantiles.size() < num_batches) {
+            series->quantiles.emplace_back(
+                begin(quantile_probs), end(quantile_probs)
+            );
+        }
+    }
+    for (auto& arm : arms_) {
+        arm.resize(num_batches);
+    }
+}
+
+void OnlineStatistics::add(Series& series, vector<double> const& values) {
+    for (auto i = 0u; i < values.size(); ++i) {
+        series.moments[i].add(values[i]);
+        for (auto& q : series.quantiles[i]) {
+            q.add(values[i]);
+        }
+    }
+}
+
+void OnlineStatistics::add(RunStatistics const& run) {
+    assert(run.arms.size() == arms_.size());
+    if (run.rewards.size() > num_batches()) {
+        resize(run.rewards.size());
+    }
+
+    add(rewards_, run.rewards);
+    add(totals_, run.totals);
+    for (auto a = 0u; a < arms_.size(); ++a) {
+        for (auto i = 0u; i < run.arms[a].size(); ++i) {
+            arms_[a][i].add(run.arms[a][i]);
+        }
+    }
+    num_runs_++;
+}
+
+namespace {
+
+auto series_to_json(OnlineStatistics::Series const& series) -> json {
+    vector<double> mean{}, variance{};
+    for (auto const& m : series.moments) {
+        mean.push_back(m.mean());
+        variance.push_back(m.variance());
+    }
+
+    json quantiles = json::object();
+    for (auto k = 0u; k < OnlineStatistics::quantile_probs.size(); ++k) {
+        vector<double> values{};
+        for (auto const& qs : series.quantiles) {
+            values.push_back(qs[k].value());
+        }
+        auto const percent = std::lround(100 * OnlineStatistics::quantile_probs[k]);
+        quantiles["p" + std::to_string(percent)] = values;
+    }
+
+    return {{"mean", mean}, {"variance", variance}, {"quantiles", quantiles}};
+}
+
+}
+
+void to_json(json& j, OnlineStatistics const& stats) {
+    vector<vector<double>> arms_mean{};
+    for (auto const& arm : stats.arms()) {
+        arms_mean.emplace_back();
+        for (auto const& m : arm) {
+            arms_mean.back().push_back(m.mean());
+        }
+    }
+
+    j = {{"num_runs", stats.num_runs()},
+         {"rewards", series_to_json(stats.rewards())},
+         {"totals", series_to_json(stats.totals())},
+         {"arms_mean", arms_mean}};
+}
+
+}
@@ -0,0 +1,115 @@
+#ifndef ONLINE_STATISTICS_H
+#define ONLINE_STATISTICS_H
+
+#include <schad/simulator/statistics.h>
+#include <schad/common.h>
+
+#include <array>
+
+namespace schad {
+
+class RunningMoments {
+public:
+    RunningMoments() : count_{0}, mean_{0.0}, m2_{0.0} {
+    }
+
+    void add(double x) {
+        count_++;
+        auto const delta = x - mean_;
+        mean_ += delta / count_;
+        m2_ += delta * (x - mean_);
+    }
+
+    auto count() const {
+        return count_;
+    }
+
+    auto mean() const {
+        return mean_;
+    }
+
+    auto variance() const {
+        return count_ > 1 ? m2_ / (count_ - 1) : 0.0;
+    }
+
+private:
+    uint64_t count_;
+    double mean_;
+    double m2_;
+};
+
+class P2Quantile {
+public:
+    explicit P2Quantile(double p);
+
+    void add(double x);
+    auto value() const -> double;
+
+private:
+    auto parabolic(size_t i, double d) const -> double;
+    auto linear(size_t i, double d) const -> double;
+
+private:
+    double const p_;
+    uint64_t count_;
+    std::array<double, 5> heights_;
+    std::array<double, 5> positions_;
+    std::array<double, 5> desired_;
+    std::array<double, 5> increments_;
+};
+
+class OnlineStatistics {
+public:
+    static constexpr std::array<double, 5> quantile_probs{
+        0.05, 0.25, 0.5, 0.75, 0.95
+    };
+
+    struct Series {
+        vector<RunningMoments> moments;
+        vector<vector<P2Quantile>> quantiles;
+    };
+
+    explicit OnlineStatistics(size_t num_arms);
+
+    void add(RunStatistics const& run);
+
+    auto num_runs() const {
+        return num_runs_;
+    }
+
+    auto num_batches() const {
+        return rewards_.moments.size();
+    }
+
+    auto num_arms() const {
+        return arms_.size();
+    }
+
+    auto rewards() const -> Series const& {
+        return rewards_;
+    }
+
+    auto totals() const -> Series const& {
+        return totals_;
+    }
+
+    auto arms() const -> vector<vector<RunningMoments>> const& {
+        return arms_;
+    }
+
+private:
+    void resize(size_t num_batches);
+    static void add(Series& series, vector<double> const& values);
+
+private:
+    uint64_t num_runs_;
+    Series rewards_;
+    Series totals_;
+    vector<vector<RunningMoments>> arms_;
+};
+
+void to_json(json& j, OnlineStatistics const& stats);
+
+}
+
+#endif // ONLINE_STATISTICS_H
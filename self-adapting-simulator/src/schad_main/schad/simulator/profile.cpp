@@ -0,0 +1,110 @@
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#include "profile.h"
+
+namespace schad {
+
+namespace {
+
+thread_local uint64_t num_allocations = 0;
+
+std::mutex collected_mutex{};
+Profile collected{};
+
+}
+
+thread_local Profile * detail::current_profile = nullptr;
+
+auto detail::allocation_count() -> uint64_t {
+    return num_allocations;
+}
+
+auto phase_name(Phase phase) -> char const * {
+    switch (phase) {
+        case Phase::SOURCE: return "source";
+        case Phase::SHADOW_ADMISSION: return "shadow_admission";
+        case Phase::REWARD: return "reward";
+        case Phase::ADMISSION: return "admission";
+        case Phase::SELECTION: return "selection";
+        case Phase::TRANSMISSION: return "transmission";
+        case Phase::LEARNING_REPORT: return "learning_report";
+        case Phase::LEARNING_CHOOSE: return "learning_choose";
+        case Phase::POLICY_SWITCH: return "policy_switch";
+        case Phase::STATS: return "stats";
+        case Phase::COUNT: break;
+    }
+    return "";
+}
+
+void Profile::merge(Profile const& other) {
+    for (auto i = 0u; i < phases_.size(); ++i) {
+        phases_[i].ns += other.phases_[i].ns;
+        phases_[i].calls += other.phases_[i].calls;
+        phases_[i].allocations += other.phases_[i].allocations;
+    }
+    num_runs_ += other.num_runs_;
+    run_ns_ += other.run_ns_;
+}
+
+void to_json(json& j, Profile const& profile) {
+    auto phases = json::object();
+    uint64_t phases_ns = 0;
+    for (auto i = 0u; i < size_t(Phase::COUNT); ++i) {
+        auto const& counters = profile.phase(Phase(i));
+        phases[phase_name(Phase(i))] = {
+            {"ns", counters.ns},
+            {"calls", counters.calls},
+            {"allocations", counters.allocations}
+        };
+        phases_ns += counters.ns;
+    }
+    j = {
+        {"num_runs", profile.num_runs()},
+        {"run_ns", profile.run_ns()},
+        {"unattributed_ns", profile.run_ns() - std::min(phases_ns, profile.run_ns())},
+        {"phases", phases}
+    };
+}
+
+auto collected_profile() -> Profile {
+    std::lock_guard<std::mutex> lock{collected_mutex};
+    return collected;
+}
+
+ProfiledRun::ProfiledRun()
+    : profile_{}, outer_{detail::current_profile},
+      start_{detail::profile_clock::now()} {
+    detail::current_profile = &profile_;
+}
+
+ProfiledRun::~ProfiledRun() {
+    profile_.add_run(detail::elapsed_ns(start_));
+    detail::current_profile = outer_;
+
+    std::lock_guard<std::mutex> lock{collected_mutex};
+    collected.merge(profile_);
+}
+
+}
+
+#ifdef SCHAD_PROFILE
+
+void * operator new(std::size_t size) {
+    schad::num_allocations++;
+    if (auto const p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void * p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void * p, [[maybe_unused]] std::size_t size) noexcept {
+    std::free(p);
+}
+
+#endif
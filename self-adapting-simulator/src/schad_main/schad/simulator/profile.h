@@ -0,0 +1,139 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <schad/common.h>
+
+#include <array>
+#include <chrono>
+
+namespace schad {
+
+#ifdef SCHAD_PROFILE
+constexpr bool profiling_enabled = true;
+#else
+constexpr bool profiling_enabled = false;
+#endif
+
+enum class Phase {
+    SOURCE, SHADOW_ADMISSION, REWARD, ADMISSION, SELECTION, TRANSMISSION,
+    LEARNING_REPORT, LEARNING_CHOOSE, POLICY_SWITCH, STATS, COUNT
+};
+
+auto phase_name(Phase phase) -> char const *;
+
+class Profile {
+public:
+    struct Counters {
+        uint64_t ns = 0;
+        uint64_t calls = 0;
+        uint64_t allocations = 0;
+    };
+
+    Profile() : phases_{}, num_runs_{0}, run_ns_{0} {
+    }
+
+    void add(Phase phase, uint64_t ns, uint64_t allocations) {
+        auto& counters = phases_[size_t(phase)];
+        counters.ns += ns;
+        counters.calls++;
+        counters.allocations += allocations;
+    }
+
+    void add_run(uint64_t ns) {
+        num_runs_++;
+        run_ns_ += ns;
+    }
+
+    void merge(Profile const& other);
+
+    auto phase(Phase phase) const -> Counters const& {
+        return phases_[size_t(phase)];
+    }
+
+    auto num_runs() const {
+        return num_runs_;
+    }
+
+    auto run_ns() const {
+        return run_ns_;
+    }
+
+private:
+    std::array<Counters, size_t(Phase::COUNT)> phases_;
+    uint64_t num_runs_;
+    uint64_t run_ns_;
+};
+
+void to_json(json& j, Profile const& profile);
+
+// Sum of the profiles of every run finished by this process so far.
+auto collected_profile() -> Profile;
+
+namespace detail {
+
+using profile_clock = std::chrono::steady_clock;
+
+extern thread_local Profile * current_profile;
+
+auto allocation_count() -> uint64_t;
+
+inline auto elapsed_ns(profile_clock::time_point since) -> uint64_t {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        profile_clock::now() - since
+    ).count();
+}
+
+}
+
+class ScopedPhase {
+public:
+    explicit ScopedPhase(Phase phase)
+        : phase_{phase}, allocations_{detail::allocation_count()},
+          start_{detail::profile_clock::now()} {
+    }
+
+    ~ScopedPhase() {
+        if (detail::current_profile != nullptr) {
+            detail::current_profile->add(
+                phase_, detail::elapsed_ns(start_),
+                detail::allocation_count() - allocations_
+            );
+        }
+    }
+
+    ScopedPhase(ScopedPhase const&) = delete;
+    ScopedPhase& operator=(ScopedPhase const&) = delete;
+
+private:
+    Phase const phase_;
+    uint64_t const allocations_;
+    detail::profile_clock::time_point const start_;
+};
+
+// Makes the phases of the calling thread count towards one run until
+// destroyed, then adds that run to the collected profile.
+class ProfiledRun {
+public:
+    ProfiledRun();
+    ~ProfiledRun();
+
+    ProfiledRun(ProfiledRun const&) = delete;
+    ProfiledRun& operator=(ProfiledRun const&) = delete;
+
+private:
+    Profile profile_;
+    Profile * const outer_;
+    detail::profile_clock::time_point const start_;
+};
+
+}
+
+#ifdef SCHAD_PROFILE
+#define SCHAD_PROFILE_RUN() ::schad::ProfiledRun schad_profiled_run_{}
+#define SCHAD_PROFILE_PHASE(phase) ::schad::ScopedPhase schad_scoped_phase_{phase}
+#else
+#define SCHAD_PROFILE_RUN() (void) 0
+#define SCHAD_PROFILE_PHASE(phase) (void) 0
+#endif
+
+#endif // PROFILE_H
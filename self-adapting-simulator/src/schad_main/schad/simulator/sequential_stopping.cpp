@@ -0,0 +1,97 @@
+#include <cmath>
+
+#include "sequential_stopping.h"
+
+namespace schad {
+
+namespace {
+
+// Continued fraction of the regularized incomplete beta function, as in
+// Numerical Recipes' betacf.
+auto beta_fraction(double a, double b, double x) -> double {
+    auto const tiny = 1e-300;
+    auto c = 1.0;
+    auto d = 1.0 - (a + b) * x / (a + 1);
+    d = 1 / (std::abs(d) < tiny ? tiny : d);
+    auto h = d;
+    auto step = [&](double num) {
+        d = 1 + num * d;
+        d = 1 / (std::abs(d) < tiny ? tiny : d);
+        c = 1 + num / c;
+        c = std::abs(c) < tiny ? tiny : c;
+        h *= d * c;
+        return d * c;
+    };
+    for (auto m = 1; m <= 300; ++m) {
+        step(m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m)));
+        auto const delta =
+            step(-(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1)));
+        if (std::abs(delta - 1) < 1e-15) {
+            break;
+        }
+    }
+    return h;
+}
+
+// Regularized incomplete beta function I_x(a, b).
+auto incomplete_beta(double a, double b, double x) -> double {
+    if (x <= 0 || x >= 1) {
+        return x <= 0 ? 0.0 : 1.0;
+    }
+    auto const front = std::exp(std::lgamma(a + b) - std::lgamma(a) -
+                                std::lgamma(b) + a * std::log(x) +
+                                b * std::log1p(-x));
+    if (x < (a + 1) / (a + b + 2)) {
+        return front * beta_fraction(a, b, x) / a;
+    }
+    return 1 - front * beta_fraction(b, a, 1 - x) / b;
+}
+
+// Quantile p > 0.5 of Student's t distribution with df degrees of freedom.
+// P(T > t) = I_x(df/2, 1/2) / 2 with x = df / (df + t^2), which grows with
+// x, so bisect on x.
+auto student_t_quantile(double p, double df) -> double {
+    auto lo = 0.0, hi = 1.0;
+    for (auto i = 0; i < 200; ++i) {
+        auto const mid = (lo + hi) / 2;
+        if (incomplete_beta(df / 2, 0.5, mid) / 2 < 1 - p) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    auto const x = (lo + hi) / 2;
+    return std::sqrt(df * (1 - x) / x);
+}
+
+}
+
+SequentialStopping::SequentialStopping(StoppingParameters const& params)
+    : min_runs_{params.min_runs()},
+      relative_half_width_{params.relative_half_width()},
+      p_{(1.0 + params.confidence()) / 2} {
+}
+
+auto SequentialStopping::converged(OnlineStatistics const& stats) const -> bool {
+    if (stats.num_runs() < min_runs_) {
+        return false;
+    }
+    auto df = uint64_t{0};
+    auto t = 0.0;
+    for (auto const& m : stats.rewards().moments) {
+        if (m.count() < 2) {
+            return false;
+        }
+        if (m.count() - 1 != df) {
+            df = m.count() - 1;
+            t = student_t_quantile(p_, static_cast<double>(df));
+        }
+        auto const half_width = t * std::sqrt(m.variance() / m.count());
+        if (half_width > relative_half_width_ * std::abs(m.mean())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
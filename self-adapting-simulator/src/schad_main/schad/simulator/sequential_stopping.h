@@ -0,0 +1,26 @@
+#ifndef SEQUENTIAL_STOPPING_H
+#define SEQUENTIAL_STOPPING_H
+
+#include <schad/simulator/online_statistics.h>
+#include <schad/simulator/simulation_parameters.h>
+
+namespace schad {
+
+// Decides whether the runs aggregated so far pin down the mean reward of
+// every batch: the Student-t confidence interval of each batch mean has to
+// be within the configured fraction of that mean.
+class SequentialStopping {
+public:
+    explicit SequentialStopping(StoppingParameters const& params);
+
+    auto converged(OnlineStatistics const& stats) const -> bool;
+
+private:
+    uint64_t const min_runs_;
+    double const relative_half_width_;
+    double const p_;    // two-sided quantile of the confidence level
+};
+
+}
+
+#endif // SEQUENTIAL_STOPPING_H
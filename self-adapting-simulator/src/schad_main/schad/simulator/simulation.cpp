@@ -1,8 +1,14 @@
 #include <iostream>
 #include <iomanip>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <thread>
 
 #include <schad/infrastructure/infrastructure.h>
+#include <schad/packet/packet_builder.h>
 #include <schad/simulator/multi_run_stats_collector.h>
+#include <schad/simulator/profile.h>
 #include "simulation.h"
 
 namespace {
@@ -43,39 +49,55 @@ public:
 
 private:
     void run_step() {
-        auto packets = src_->next(current_step_);
+        auto packets = next_packets();
         for (auto [p,r] : infra_->simulated_policies()) {
-            vector<unique_ptr<Packet>> packets_clone(packets.size());
-            std::transform(begin(packets), end(packets), begin(packets_clone), 
-                [](auto const& p) {
-                    return p->clone();
-                }
-            );
-
-            process_admission(*p, *r, std::move(packets_clone));
+            note_arrivals(*r, packets);
+            {
+                SCHAD_PROFILE_PHASE(Phase::SHADOW_ADMISSION);
+                p->admit_shared(packets);
+            }
+            process(*p, *r);
         }
         auto [active_policy, active_reward] = infra_->active_policy();
-        process_admission(*active_policy, *active_reward, std::move(packets));
+        note_arrivals(*active_reward, packets);
+        {
+            SCHAD_PROFILE_PHASE(Phase::ADMISSION);
+            active_policy->admit_n_drop(std::move(packets));
+        }
+        process(*active_policy, *active_reward);
 
         infra_->tick();
         current_step_++;
     }
 
-    void process_admission(PolicyInstance &policy, RewardFunction &reward, 
-                vector<unique_ptr<Packet>> packets) {
-        for (auto const& p : packets) {
-            reward.note_arrival(*p);
-        }
-        policy.admit_n_drop(std::move(packets));
+    auto next_packets() -> vector<unique_ptr<Packet>> {
+        SCHAD_PROFILE_PHASE(Phase::SOURCE);
+        return src_->next(current_step_);
+    }
+
+    static void note_arrivals(RewardFunction& reward, 
+            vector<unique_ptr<Packet>> const& packets) {
+        SCHAD_PROFILE_PHASE(Phase::REWARD);
+        reward.note_arrivals(packets);
+    }
 
-        auto next_to_process = policy.select_for_processing();
-        if (next_to_process != nullptr) {
-            next_to_process->process();
-            policy.processing_finished(next_to_process);
+    void process(PolicyInstance &policy, RewardFunction &reward) {
+        {
+            SCHAD_PROFILE_PHASE(Phase::SELECTION);
+            auto next_to_process = policy.select_for_processing();
+            if (next_to_process != nullptr) {
+                next_to_process->process();
+                policy.processing_finished(next_to_process);
+            }
         }
 
-        auto transmitted = policy.transmit();
+        unique_ptr<Packet> transmitted{};
+        {
+            SCHAD_PROFILE_PHASE(Phase::TRANSMISSION);
+            transmitted = policy.transmit();
+        }
         if (transmitted) {
+            SCHAD_PROFILE_PHASE(Phase::REWARD);
             reward.note_transmission(current_step_, *transmitted);
         }
     }
@@ -89,36 +111,103 @@ private:
     unique_ptr<Infrastructure> const infra_; 
 };
 
+auto make_run_rngs(uint64_t seed, uint64_t run_idx) 
+        -> tuple<shared_ptr<rng_t>, shared_ptr<rng_t>> {
+    std::seed_seq seq{
+        uint32_t(seed), uint32_t(seed >> 32), 
+        uint32_t(run_idx), uint32_t(run_idx >> 32)
+    };
+    auto internal_rng = make_shared<rng_t>(seq);
+    auto external_rng = make_shared<rng_t>((*internal_rng)());
+    return make_tuple(std::move(internal_rng), std::move(external_rng));
+}
 
 }
 
-auto schad::run(ExperimentParameters const& params) -> Statistics {
-    auto internal_rng = make_shared<rng_t>(
-        params.simulation_parameters().seed()
-    );
-    auto external_rng = make_shared<rng_t>((*internal_rng)());
+void schad::run(
+        ExperimentParameters const& params, StatsSink& sink, size_t num_threads) {
+    auto const num_runs = params.simulation_parameters().num_runs();
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = std::min<size_t>(num_threads, std::max<uint64_t>(num_runs, 1));
+
+    vector<unique_ptr<MultiRunStatsCollector>> shards(num_threads);
+    std::generate(begin(shards), end(shards), [&params, &sink] {
+        return make_unique<MultiRunStatsCollector>(
+            params.policies().size(), 
+            params.simulation_parameters().stat_batch_size(),
+            sink
+        );
+    });
+
+    if (auto const& stopping = params.simulation_parameters().stopping()) {
+        sink.stop_when(*stopping);
+    }
 
-    MultiRunStatsCollector stats{
-        params.policies().size(), 
-        params.simulation_parameters().stat_batch_size()
-    }; 
+    std::atomic<uint64_t> next_run_idx{0};
+    std::mutex progress_mutex{};
+    uint64_t num_finished = 0;
 
-    for (auto i = 0u; i < params.simulation_parameters().num_runs(); ++i) {
-        std::cerr  << "Run #" << std::setw(5) << (i + 1) << " of " 
-            << std::setw(5) << params.simulation_parameters().num_runs();
-        if (i + 1 == params.simulation_parameters().num_runs()) {
+    auto const report_progress = [&] {
+        std::lock_guard<std::mutex> lock{progress_mutex};
+        num_finished++;
+        std::cerr  << "Run #" << std::setw(5) << num_finished << " of " 
+            << std::setw(5) << num_runs;
+        if (num_finished == num_runs) {
             std::cerr << "\n";
         } else {
             std::cerr << "\r";
         }
+    };
+
+    auto const worker = [&] (MultiRunStatsCollector& stats) {
+        for (auto i = next_run_idx++; i < num_runs && !sink.stopped();
+                i = next_run_idx++) {
+            auto const [internal_rng, external_rng] = 
+                make_run_rngs(params.simulation_parameters().seed(), i);
+
+            stats.next_run(i);
+            PacketBuilder::reset_ids();
+            {
+                SCHAD_PROFILE_RUN();
+                Simulator{
+                    params.simulation_parameters(), params.infra_params(), 
+                    *params.learning(), params.policies(), *params.reward(), &stats,
+                    params.source()->instantiate_run(external_rng, i), internal_rng
+                }.run();
+            }
+            stats.finish_run();
+
+            report_progress();
+        }
+    };
+
+    if (num_threads == 1) {
+        worker(*shards.front());
+    } else {
+        vector<std::future<void>> workers{};
+        for (auto& shard : shards) {
+            workers.emplace_back(std::async(
+                std::launch::async, worker, std::ref(*shard)
+            ));
+        }
+        for (auto& w : workers) {
+            w.get();
+        }
+    }
 
-        stats.next_run();
-        Simulator{
-            params.simulation_parameters(), params.infra_params(), 
-            *params.learning(), params.policies(), *params.reward(), &stats,
-            params.source()->instantiate(external_rng), internal_rng
-        }.run();
+    if (sink.stopped()) {
+        std::cerr << "\nConverged after " << sink.aggregates().num_runs()
+            << " runs\n";
     }
 
-    return stats.get_statistics();
+    sink.finish();
+}
+
+auto schad::run(ExperimentParameters const& params, size_t num_threads) 
+        -> Statistics {
+    InMemoryStatsSink sink{params.policies().size()};
+    run(params, sink, num_threads);
+    return sink.get_statistics();
 }
@@ -3,12 +3,14 @@
 
 #include <schad/simulator/experiment_parameters.h>
 #include <schad/simulator/statistics.h>
+#include <schad/simulator/stats_sink.h>
 #include <schad/common.h>
 
 
 namespace schad {
 
-auto run(ExperimentParameters const& parms) -> Statistics;
+void run(ExperimentParameters const& parms, StatsSink& sink, size_t num_threads = 1);
+auto run(ExperimentParameters const& parms, size_t num_threads = 1) -> Statistics;
 
 }
 
@@ -5,9 +5,48 @@
 
 namespace schad {
 
+struct StoppingParameters {
+    StoppingParameters()
+        : relative_half_width_{0.01}, confidence_{0.95}, min_runs_{10} {
+    }
+
+    auto& set_relative_half_width(double relative_half_width) {
+        relative_half_width_ = relative_half_width;
+        return *this;
+    }
+
+    auto relative_half_width() const {
+        return relative_half_width_;
+    }
+
+    auto& set_confidence(double confidence) {
+        confidence_ = confidence;
+        return *this;
+    }
+
+    auto confidence() const {
+        return confidence_;
+    }
+
+    auto& set_min_runs(uint64_t min_runs) {
+        min_runs_ = min_runs;
+        return *this;
+    }
+
+    auto min_runs() const {
+        return min_runs_;
+    }
+
+private:
+    double relative_half_width_;
+    double confidence_;
+    uint64_t min_runs_;
+};
+
 struct SimulationParameters {
     SimulationParameters()
-        : num_time_steps_{100}, num_runs_{1}, stat_batch_size_{1}, seed_{42} {
+        : num_time_steps_{100}, num_runs_{1}, stat_batch_size_{1}, seed_{42},
+          stopping_{} {
     }
 
     auto& set_num_runs(uint64_t num_runs) {
@@ -46,11 +85,21 @@ struct SimulationParameters {
         return stat_batch_size_;
     }
 
+    auto& set_stopping(optional<StoppingParameters> stopping) {
+        stopping_ = stopping;
+        return *this;
+    }
+
+    auto const& stopping() const {
+        return stopping_;
+    }
+
 private:
     uint64_t num_time_steps_;
     uint64_t num_runs_;
     uint64_t stat_batch_size_;
     uint64_t seed_;
+    optional<StoppingParameters> stopping_;
 };
 
 }
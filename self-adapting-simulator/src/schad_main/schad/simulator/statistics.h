@@ -5,6 +5,12 @@
 
 namespace schad {
 
+struct RunStatistics {
+    vector<double> rewards;
+    vector<double> totals;
+    vector<vector<size_t>> arms;
+};
+
 struct Statistics {
     Statistics(vector<vector<double>> rewards, 
                vector<vector<double>> totals, 
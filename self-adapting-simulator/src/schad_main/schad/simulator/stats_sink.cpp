@@ -0,0 +1,62 @@
+#include <stdexcept>
+
+#include "stats_sink.h"
+
+namespace schad {
+
+StatsSink::StatsSink(size_t num_arms)
+    : mutex_{}, next_run_idx_{0}, pending_{}, aggregates_{num_arms},
+      stopping_{}, stopped_{false} {
+}
+
+void StatsSink::stop_when(StoppingParameters const& params) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stopping_.emplace(params);
+}
+
+void StatsSink::consume(uint64_t run_idx, RunStatistics run) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (stopped_) {
+        return;
+    }
+    pending_.emplace(run_idx, std::move(run));
+
+    for (auto it = pending_.begin();
+            it != pending_.end() && it->first == next_run_idx_;
+            it = pending_.erase(it)) {
+        aggregates_.add(it->second);
+        write(std::move(it->second));
+        next_run_idx_++;
+
+        if (stopping_ && stopping_->converged(aggregates_)) {
+            stopped_ = true;
+            pending_.clear();
+            break;
+        }
+    }
+}
+
+void StatsSink::finish() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (!pending_.empty()) {
+        throw std::logic_error(
+            "missing statistics of run #" + std::to_string(next_run_idx_)
+        );
+    }
+}
+
+InMemoryStatsSink::InMemoryStatsSink(size_t num_arms)
+    : StatsSink{num_arms}, rewards_{}, totals_{}, arms_{} {
+}
+
+void InMemoryStatsSink::write(RunStatistics run) {
+    rewards_.push_back(std::move(run.rewards));
+    totals_.push_back(std::move(run.totals));
+    arms_.push_back(std::move(run.arms));
+}
+
+auto InMemoryStatsSink::get_statistics() const -> Statistics {
+    return Statistics{rewards_, totals_, arms_};
+}
+
+}
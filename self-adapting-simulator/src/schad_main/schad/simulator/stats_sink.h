@@ -0,0 +1,68 @@
+#ifndef STATS_SINK_H
+#define STATS_SINK_H
+
+#include <schad/simulator/online_statistics.h>
+#include <schad/simulator/sequential_stopping.h>
+#include <schad/simulator/statistics.h>
+#include <schad/common.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+
+namespace schad {
+
+class StatsSink {
+public:
+    explicit StatsSink(size_t num_arms);
+
+    StatsSink(StatsSink const&) = delete;
+    StatsSink& operator=(StatsSink const&) = delete;
+
+    virtual ~StatsSink() = default;
+
+    void consume(uint64_t run_idx, RunStatistics run);
+    virtual void finish();
+
+    // Once the runs consumed in order satisfy the rule, every later run is
+    // discarded and stopped() becomes true.
+    void stop_when(StoppingParameters const& params);
+
+    auto stopped() const -> bool {
+        return stopped_;
+    }
+
+    auto aggregates() const -> OnlineStatistics const& {
+        return aggregates_;
+    }
+
+protected:
+    virtual void write(RunStatistics run) = 0;
+
+private:
+    std::mutex mutex_;
+    uint64_t next_run_idx_;
+    std::map<uint64_t, RunStatistics> pending_;
+    OnlineStatistics aggregates_;
+    optional<SequentialStopping> stopping_;
+    std::atomic<bool> stopped_;
+};
+
+class InMemoryStatsSink : public StatsSink {
+public:
+    explicit InMemoryStatsSink(size_t num_arms);
+
+    auto get_statistics() const -> Statistics;
+
+protected:
+    void write(RunStatistics run) override;
+
+private:
+    vector<vector<double>> rewards_;
+    vector<vector<double>> totals_;
+    vector<vector<vector<size_t>>> arms_;
+};
+
+}
+
+#endif // STATS_SINK_H
@@ -0,0 +1,146 @@
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "arrival_file.h"
+
+namespace schad {
+
+namespace {
+
+auto offsets_size(uint64_t num_time_steps) -> uint64_t {
+    return ((num_time_steps + 1) * sizeof(uint32_t) + 7) / 8 * 8;
+}
+
+}
+
+ArrivalRecorder::ArrivalRecorder(string path, uint64_t num_time_steps)
+    : path_{std::move(path)}, num_time_steps_{num_time_steps}, mutex_{},
+      out_{path_, std::ios::binary | std::ios::trunc},
+      offset_{sizeof(ArrivalFileHeader)}, run_offsets_{} {
+    if (!out_) {
+        throw arrival_file_exception(path_, "cannot open for writing");
+    }
+    ArrivalFileHeader header{};
+    out_.write(reinterpret_cast<char const *>(&header), sizeof(header));
+}
+
+void ArrivalRecorder::commit(uint64_t run_idx, RecordedRun const& run) {
+    assert(run.offsets.size() == num_time_steps_ + 1);
+
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (!run_offsets_.emplace(run_idx, offset_).second) {
+        throw arrival_file_exception(
+            path_, "run #" + std::to_string(run_idx) + " recorded twice"
+        );
+    }
+
+    auto const padding = offsets_size(num_time_steps_) 
+        - run.offsets.size() * sizeof(uint32_t);
+    out_.write(
+        reinterpret_cast<char const *>(run.offsets.data()),
+        run.offsets.size() * sizeof(uint32_t)
+    );
+    out_.write(string(padding, '\0').data(), padding);
+    out_.write(
+        reinterpret_cast<char const *>(run.records.data()),
+        run.records.size() * sizeof(ArrivalRecord)
+    );
+    offset_ += offsets_size(num_time_steps_) 
+        + run.records.size() * sizeof(ArrivalRecord);
+}
+
+void ArrivalRecorder::finish() {
+    std::lock_guard<std::mutex> lock{mutex_};
+
+    vector<uint64_t> index{};
+    for (auto const& [run_idx, offset] : run_offsets_) {
+        if (run_idx != index.size()) {
+            throw arrival_file_exception(
+                path_, "run #" + std::to_string(index.size()) + " was not recorded"
+            );
+        }
+        index.push_back(offset);
+    }
+    out_.write(
+        reinterpret_cast<char const *>(index.data()), 
+        index.size() * sizeof(uint64_t)
+    );
+
+    ArrivalFileHeader header{};
+    std::memcpy(header.magic, ArrivalFileHeader::magic_value, sizeof(header.magic));
+    header.version = ArrivalFileHeader::version_value;
+    header.record_size = sizeof(ArrivalRecord);
+    header.num_runs = index.size();
+    header.num_time_steps = num_time_steps_;
+    header.index_offset = offset_;
+    out_.seekp(0);
+    out_.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    out_.close();
+    if (!out_) {
+        throw arrival_file_exception(path_, "write failed");
+    }
+}
+
+ArrivalFile::ArrivalFile(string path)
+    : path_{std::move(path)}, data_{nullptr}, size_{0} {
+    auto const fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw arrival_file_exception(path_, "cannot open for reading");
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(ArrivalFileHeader)) {
+        ::close(fd);
+        throw arrival_file_exception(path_, "truncated header");
+    }
+    size_ = st.st_size;
+
+    auto const mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw arrival_file_exception(path_, "mmap failed");
+    }
+    data_ = static_cast<unsigned char const *>(mapped);
+
+    auto const& h = header();
+    auto const valid =
+        std::memcmp(h.magic, ArrivalFileHeader::magic_value, sizeof(h.magic)) == 0 &&
+        h.version == ArrivalFileHeader::version_value &&
+        h.record_size == sizeof(ArrivalRecord) &&
+        h.index_offset + h.num_runs * sizeof(uint64_t) <= size_;
+    if (!valid) {
+        ::munmap(const_cast<unsigned char *>(data_), size_);
+        throw arrival_file_exception(path_, "not a complete arrival file");
+    }
+}
+
+ArrivalFile::~ArrivalFile() {
+    ::munmap(const_cast<unsigned char *>(data_), size_);
+}
+
+auto ArrivalFile::run_offset(uint64_t run_idx) const -> uint64_t {
+    if (run_idx >= num_runs()) {
+        throw arrival_file_exception(
+            path_, "run #" + std::to_string(run_idx) + " was not recorded"
+        );
+    }
+    return reinterpret_cast<uint64_t const *>(
+        data_ + header().index_offset
+    )[run_idx];
+}
+
+auto ArrivalFile::offsets(uint64_t run_idx) const -> uint32_t const * {
+    return reinterpret_cast<uint32_t const *>(data_ + run_offset(run_idx));
+}
+
+auto ArrivalFile::records(uint64_t run_idx) const -> ArrivalRecord const * {
+    return reinterpret_cast<ArrivalRecord const *>(
+        data_ + run_offset(run_idx) + offsets_size(num_time_steps())
+    );
+}
+
+}
@@ -0,0 +1,111 @@
+#ifndef ARRIVAL_FILE_H
+#define ARRIVAL_FILE_H
+
+#include <schad/packet/packet.h>
+
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace schad {
+
+struct arrival_file_exception : std::runtime_error {
+    arrival_file_exception(string const& path, string const& reason)
+        : std::runtime_error(path + ": " + reason) {
+    }
+};
+
+struct ArrivalFileHeader {
+    static constexpr char magic_value[8] = "SCHADAR";
+    static constexpr uint32_t version_value = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t num_runs;
+    uint64_t num_time_steps;
+    uint64_t index_offset;
+    uint64_t reserved[3];
+};
+
+static_assert(sizeof(ArrivalFileHeader) == 64);
+
+struct ArrivalRecord {
+    static constexpr uint32_t no_slack = std::numeric_limits<uint32_t>::max();
+
+    double value;
+    uint32_t initial_processing;
+    uint32_t slack;
+};
+
+static_assert(sizeof(ArrivalRecord) == 16);
+
+struct RecordedRun {
+    vector<uint32_t> offsets;
+    vector<ArrivalRecord> records;
+};
+
+class ArrivalRecorder {
+public:
+    ArrivalRecorder(string path, uint64_t num_time_steps);
+
+    ArrivalRecorder(ArrivalRecorder const&) = delete;
+    ArrivalRecorder& operator=(ArrivalRecorder const&) = delete;
+
+    auto num_time_steps() const {
+        return num_time_steps_;
+    }
+
+    void commit(uint64_t run_idx, RecordedRun const& run);
+    void finish();
+
+private:
+    string const path_;
+    uint64_t const num_time_steps_;
+    std::mutex mutex_;
+    std::ofstream out_;
+    uint64_t offset_;
+    std::map<uint64_t, uint64_t> run_offsets_;
+};
+
+class ArrivalFile {
+public:
+    explicit ArrivalFile(string path);
+    ~ArrivalFile();
+
+    ArrivalFile(ArrivalFile const&) = delete;
+    ArrivalFile& operator=(ArrivalFile const&) = delete;
+
+    auto path() const -> string const& {
+        return path_;
+    }
+
+    auto num_runs() const {
+        return header().num_runs;
+    }
+
+    auto num_time_steps() const {
+        return header().num_time_steps;
+    }
+
+    auto offsets(uint64_t run_idx) const -> uint32_t const *;
+    auto records(uint64_t run_idx) const -> ArrivalRecord const *;
+
+private:
+    auto header() const -> ArrivalFileHeader const& {
+        return *reinterpret_cast<ArrivalFileHeader const *>(data_);
+    }
+
+    auto run_offset(uint64_t run_idx) const -> uint64_t;
+
+private:
+    string const path_;
+    unsigned char const * data_;
+    size_t size_;
+};
+
+}
+
+#endif // ARRIVAL_FILE_H
@@ -34,11 +34,16 @@ public:
     }
 
     auto instantiate(shared_ptr<rng_t> rng) const -> unique_ptr<Source> override {
+        return instantiate_run(std::move(rng), 0);
+    }
+
+    auto instantiate_run(shared_ptr<rng_t> rng, uint64_t run_idx) const 
+            -> unique_ptr<Source> override {
         vector<std::discrete_distribution<size_t>> tr{};
         vector<std::unique_ptr<Source>> srcs{};
 
         for (auto const& s : params_.states()) {
-            srcs.emplace_back(s.src()->instantiate(rng));
+            srcs.emplace_back(s.src()->instantiate_run(rng, run_idx));
 
             vector<double> weights(params_.states().size(), 0.0);
             std::transform(
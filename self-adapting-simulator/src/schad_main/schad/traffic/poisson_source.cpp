@@ -5,6 +5,7 @@
 #include <random>
 #include <exception>
 #include <schad/packet/packet_builder.h>
+#include <schad/random/philox.h>
 
 namespace {
 using namespace schad;
@@ -47,6 +48,126 @@ private:
     shared_ptr<rng_t> rng_;
 };
 
+// Draws the arrivals of block_size time steps at once from its own Philox
+// stream, keyed by the run RNG and the run index: all counts first, then
+// the raw bits of every packet in one fill, which are mapped to work, value
+// and slack in separate tight loops.
+class BlockPoissonSource : public Source {
+public:
+    BlockPoissonSource(PoissonSourceParameters const& params, Philox4x64 rng)
+        : params_{params}, rng_{std::move(rng)}, count_cdf_{}, count_dis_{params.rate()},
+          counts_(params.block_size()), step_{params.block_size()},
+          bits_{}, works_{}, values_{}, slacks_{}, cursor_{0} {
+        if (params.rate() < max_tabulated_rate) {
+            tabulate_counts(params.rate());
+        }
+    }
+
+    auto next(uint32_t time) -> vector<unique_ptr<Packet>> override {
+        if (step_ == counts_.size()) {
+            refill();
+        }
+
+        vector<unique_ptr<Packet>> result{};
+        result.reserve(counts_[step_]);
+        for (auto end = cursor_ + counts_[step_]; cursor_ < end; ++cursor_) {
+            auto builder = PacketBuilder::create()
+                .set_initial_processing(works_[cursor_])
+                .set_value(values_[cursor_])
+                .set_time_of_arrival(time);
+            if (!slacks_.empty()) {
+                builder.set_slack(slacks_[cursor_]);
+            }
+            result.push_back(builder.build());
+        }
+        step_++;
+        return result;
+    }
+
+private:
+    static constexpr double max_tabulated_rate = 16.0;
+
+    void tabulate_counts(double rate) {
+        auto pmf = std::exp(-rate);
+        auto cdf = pmf;
+        count_cdf_.push_back(cdf);
+        for (auto k = 1u; cdf < 1.0 - 0x1.0p-53 && k < 256; ++k) {
+            pmf *= rate / k;
+            cdf += pmf;
+            count_cdf_.push_back(cdf);
+        }
+    }
+
+    auto draw_count() -> uint32_t {
+        if (count_cdf_.empty()) {
+            return count_dis_(rng_);
+        }
+        auto const u = to_unit_interval(rng_());
+        auto k = 0u;
+        while (k + 1 < count_cdf_.size() && u >= count_cdf_[k]) {
+            k++;
+        }
+        return k;
+    }
+
+    void refill() {
+        size_t total = 0;
+        for (auto& count : counts_) {
+            count = draw_count();
+            total += count;
+        }
+
+        auto const has_slack = params_.min_slack().has_value();
+        bits_.resize((has_slack ? 3 : 2) * total);
+        rng_.fill(begin(bits_), bits_.size());
+
+        uint64_t const work_range = params_.max_work() - params_.min_work() + 1;
+        works_.resize(total);
+        for (auto i = 0u; i < total; ++i) {
+            works_[i] = params_.min_work() + uint32_t(
+                ((unsigned __int128) bits_[i] * work_range) >> 64
+            );
+        }
+
+        auto const value_range = params_.max_value() - params_.min_value();
+        values_.resize(total);
+        for (auto i = 0u; i < total; ++i) {
+            values_[i] = params_.min_value()
+                + value_range * to_unit_interval(bits_[total + i]);
+        }
+
+        slacks_.clear();
+        if (has_slack) {
+            auto const min_slack = *params_.min_slack();
+            auto const slack_range = *params_.max_slack() - min_slack;
+            slacks_.resize(total);
+            for (auto i = 0u; i < total; ++i) {
+                auto const factor = min_slack
+                    + slack_range * to_unit_interval(bits_[2 * total + i]);
+                slacks_[i] = uint32_t(round(works_[i] * factor));
+            }
+        }
+
+        step_ = 0;
+        cursor_ = 0;
+    }
+
+private:
+    PoissonSourceParameters const params_;
+    Philox4x64 rng_;
+    vector<double> count_cdf_;
+    std::poisson_distribution<uint32_t> count_dis_;
+
+    vector<uint32_t> counts_;
+    size_t step_;
+
+    vector<uint64_t> bits_;
+    vector<uint32_t> works_;
+    vector<double> values_;
+    vector<uint32_t> slacks_;
+    size_t cursor_;
+};
+
 class PoissonSourceFactory : public SourceFactory {
 public:
     PoissonSourceFactory(PoissonSourceParameters params)
@@ -54,6 +175,16 @@ public:
     }
 
     auto instantiate(shared_ptr<rng_t> rng) const -> unique_ptr<Source> override {
+        return instantiate_run(std::move(rng), 0);
+    }
+
+    auto instantiate_run(shared_ptr<rng_t> rng, uint64_t run_idx) const 
+            -> unique_ptr<Source> override {
+        if (params_.block_size() > 0) {
+            return make_unique<BlockPoissonSource>(
+                params_, Philox4x64{(*rng)(), run_idx}
+            );
+        }
         return make_unique<PoissonSource>(params_, std::move(rng));
     }
 
@@ -10,7 +10,7 @@ public:
     PoissonSourceParameters(double rate = 1.0)
         : rate_{rate}, min_value_{1.0}, max_value_{1.0},
           min_work_{1}, max_work_{1}, 
-          min_slack_{}, max_slack_{} {
+          min_slack_{}, max_slack_{}, block_size_{0} {
     }
 
     auto& set_min_value(double min_value) {
@@ -76,6 +76,15 @@ public:
         return max_slack_;
     }
 
+    auto& set_block_size(uint32_t block_size) {
+        block_size_ = block_size;
+        return *this;
+    }
+
+    auto block_size() const {
+        return block_size_;
+    }
+
 private:
     double rate_;
     double min_value_;
@@ -84,6 +93,7 @@ private:
     uint32_t max_work_;
     optional<double> min_slack_;
     optional<double> max_slack_;
+    uint32_t block_size_;
 };
 
 inline void to_json(json& j, PoissonSourceParameters const& params) {
@@ -100,6 +110,9 @@ inline void to_json(json& j, PoissonSourceParameters const& params) {
             {"max", *params.max_slack()}
         };
     }
+    if (params.block_size() > 0) {
+        j["block_size"] = params.block_size();
+    }
 }
 
 } // namespace schad_main
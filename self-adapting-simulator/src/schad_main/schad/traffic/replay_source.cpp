@@ -0,0 +1,144 @@
+#include <schad/packet/packet_builder.h>
+
+#include "replay_source.h"
+
+namespace {
+
+using namespace schad;
+
+class RecordingSource : public Source {
+public:
+    RecordingSource(unique_ptr<Source> src, 
+            shared_ptr<ArrivalRecorder> recorder, uint64_t run_idx)
+        : src_{std::move(src)}, recorder_{std::move(recorder)}, 
+          run_idx_{run_idx}, run_{} {
+        run_.offsets.reserve(recorder_->num_time_steps() + 1);
+        run_.offsets.push_back(0);
+    }
+
+    auto next(uint32_t time) -> vector<unique_ptr<Packet>> override {
+        auto packets = src_->next(time);
+        for (auto const& p : packets) {
+            if (p->time_of_arrival() != time) {
+                throw std::logic_error("recorded packet arrives out of step");
+            }
+            run_.records.push_back(ArrivalRecord{
+                p->value(), p->initial_processing(), 
+                p->slack().value_or(ArrivalRecord::no_slack)
+            });
+        }
+        run_.offsets.push_back(run_.records.size());
+
+        if (time + 1 == recorder_->num_time_steps()) {
+            recorder_->commit(run_idx_, run_);
+        }
+        return packets;
+    }
+
+private:
+    unique_ptr<Source> const src_;
+    shared_ptr<ArrivalRecorder> const recorder_;
+    uint64_t const run_idx_;
+    RecordedRun run_;
+};
+
+class RecordingSourceFactory : public SourceFactory {
+public:
+    RecordingSourceFactory(shared_ptr<SourceFactory> src, 
+            shared_ptr<ArrivalRecorder> recorder)
+        : src_{std::move(src)}, recorder_{std::move(recorder)} {
+    }
+
+    auto instantiate(shared_ptr<rng_t> rng) const -> unique_ptr<Source> override {
+        return instantiate_run(std::move(rng), 0);
+    }
+
+    auto instantiate_run(shared_ptr<rng_t> rng, uint64_t run_idx) const 
+            -> unique_ptr<Source> override {
+        return make_unique<RecordingSource>(
+            src_->instantiate_run(std::move(rng), run_idx), recorder_, run_idx
+        );
+    }
+
+    void to_json(json& j) const override {
+        src_->to_json(j);
+    }
+
+private:
+    shared_ptr<SourceFactory> const src_;
+    shared_ptr<ArrivalRecorder> const recorder_;
+};
+
+class ReplaySource : public Source {
+public:
+    ReplaySource(shared_ptr<ArrivalFile const> file, uint64_t run_idx)
+        : file_{std::move(file)}, offsets_{file_->offsets(run_idx)}, 
+          records_{file_->records(run_idx)} {
+    }
+
+    auto next(uint32_t time) -> vector<unique_ptr<Packet>> override {
+        if (time >= file_->num_time_steps()) {
+            throw std::out_of_range(
+                file_->path() + ": no arrivals recorded for step " 
+                    + std::to_string(time)
+            );
+        }
+
+        vector<unique_ptr<Packet>> packets{};
+        packets.reserve(offsets_[time + 1] - offsets_[time]);
+        for (auto i = offsets_[time]; i < offsets_[time + 1]; ++i) {
+            auto const& r = records_[i];
+            auto builder = PacketBuilder::create()
+                .set_time_of_arrival(time)
+                .set_initial_processing(r.initial_processing)
+                .set_value(r.value);
+            if (r.slack != ArrivalRecord::no_slack) {
+                builder.set_slack(r.slack);
+            }
+            packets.push_back(builder.build());
+        }
+        return packets;
+    }
+
+private:
+    shared_ptr<ArrivalFile const> const file_;
+    uint32_t const * const offsets_;
+    ArrivalRecord const * const records_;
+};
+
+class ReplaySourceFactory : public SourceFactory {
+public:
+    explicit ReplaySourceFactory(string path) 
+        : file_{make_shared<ArrivalFile const>(std::move(path))} {
+    }
+
+    auto instantiate(shared_ptr<rng_t>) const -> unique_ptr<Source> override {
+        throw std::logic_error(
+            "replay source is indexed by run and must be the top-level source"
+        );
+    }
+
+    auto instantiate_run(shared_ptr<rng_t>, uint64_t run_idx) const 
+            -> unique_ptr<Source> override {
+        return make_unique<ReplaySource>(file_, run_idx);
+    }
+
+    void to_json(json& j) const override {
+        j = {{"type", "replay"}, {"parameters", {{"path", file_->path()}}}};
+    }
+
+private:
+    shared_ptr<ArrivalFile const> const file_;
+};
+
+}
+
+auto schad::create_recording_source(
+        shared_ptr<SourceFactory> src, shared_ptr<ArrivalRecorder> recorder) 
+        -> unique_ptr<SourceFactory> {
+    return make_unique<RecordingSourceFactory>(std::move(src), std::move(recorder));
+}
+
+auto schad::create_replay_source(string path) -> unique_ptr<SourceFactory> {
+    return make_unique<ReplaySourceFactory>(std::move(path));
+}
@@ -0,0 +1,17 @@
+#ifndef REPLAY_SOURCE_H
+#define REPLAY_SOURCE_H
+
+#include <schad/traffic/source.h>
+#include <schad/traffic/arrival_file.h>
+
+namespace schad {
+
+auto create_recording_source(
+        shared_ptr<SourceFactory> src, shared_ptr<ArrivalRecorder> recorder) 
+    -> unique_ptr<SourceFactory>;
+
+auto create_replay_source(string path) -> unique_ptr<SourceFactory>;
+
+}
+
+#endif // REPLAY_SOURCE_H
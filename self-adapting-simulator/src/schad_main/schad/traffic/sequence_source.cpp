@@ -36,9 +36,14 @@ public:
     }
 
     auto instantiate(shared_ptr<rng_t> rng) const -> unique_ptr<Source> override {
+        return instantiate_run(std::move(rng), 0);
+    }
+
+    auto instantiate_run(shared_ptr<rng_t> rng, uint64_t run_idx) const 
+            -> unique_ptr<Source> override {
         std::vector<unique_ptr<Source>> sources(params_.sources().size());
         std::transform(begin(params_.sources()), end(params_.sources()), begin(sources),
-                [&rng](auto const& x) { return x->instantiate(rng); });
+                [&rng, run_idx](auto const& x) { return x->instantiate_run(rng, run_idx); });
         return make_unique<SequenceSource>(params_.num_steps(), std::move(sources));
     }
 
@@ -18,6 +18,11 @@ struct Source {
 struct SourceFactory {
     virtual auto instantiate(shared_ptr<rng_t> rng) const -> unique_ptr<Source> = 0;
 
+    virtual auto instantiate_run(shared_ptr<rng_t> rng, 
+            [[maybe_unused]] uint64_t run_idx) const -> unique_ptr<Source> {
+        return instantiate(std::move(rng));
+    }
+
     virtual void to_json(json& json) const = 0;
 
     SourceFactory() = default;
@@ -33,9 +33,14 @@ public:
     }
 
     auto instantiate(shared_ptr<rng_t> rng) const -> unique_ptr<Source> override {
+        return instantiate_run(std::move(rng), 0);
+    }
+
+    auto instantiate_run(shared_ptr<rng_t> rng, uint64_t run_idx) const 
+            -> unique_ptr<Source> override {
         vector<unique_ptr<Source>> srcs{};
         for (auto const& factory : srcs_) {
-            srcs.emplace_back(factory->instantiate(rng));
+            srcs.emplace_back(factory->instantiate_run(rng, run_idx));
         }
         return make_unique<UnionSource>(std::move(rng), std::move(srcs));
     }